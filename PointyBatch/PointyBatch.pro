@@ -0,0 +1,61 @@
+#-------------------------------------------------
+#
+# Headless batch processor for recorded Pointy sessions
+#
+#-------------------------------------------------
+
+QT       -= core gui
+CONFIG   += console c++11
+CONFIG   -= app_bundle qt
+
+TARGET = PointyBatch
+
+TEMPLATE = app
+
+POINTY = $$_PRO_FILE_PWD_/../SpatialPointer
+
+INCLUDEPATH += $$POINTY
+
+unix: LIBS += -lpthread
+
+SOURCES += main.cpp \
+    prediction_metrics.cpp \
+    smoothing_metrics.cpp \
+    $$POINTY/ballistics_curve.cpp \
+    $$POINTY/block_kernels.cpp \
+    $$POINTY/dwell_detector.cpp \
+    $$POINTY/filter_bank.cpp \
+    $$POINTY/gyro_bias_estimator.cpp \
+    $$POINTY/memory_mapped_file.cpp \
+    $$POINTY/one_euro_filter.cpp \
+    $$POINTY/output_coalescer.cpp \
+    $$POINTY/pointer_motion.cpp \
+    $$POINTY/rate_kalman.cpp \
+    $$POINTY/sample_block.cpp \
+    $$POINTY/session_directory.cpp \
+    $$POINTY/session_reader.cpp \
+    $$POINTY/session_simulation.cpp \
+    $$POINTY/tremor_estimator.cpp
+
+HEADERS += \
+    prediction_metrics.h \
+    smoothing_metrics.h \
+    $$POINTY/ballistics_curve.h \
+    $$POINTY/block_kernels.h \
+    $$POINTY/dwell_detector.h \
+    $$POINTY/filter_bank.h \
+    $$POINTY/gyro_bias_estimator.h \
+    $$POINTY/linear_algebra.h \
+    $$POINTY/memory_mapped_file.h \
+    $$POINTY/one_euro_filter.h \
+    $$POINTY/output_coalescer.h \
+    $$POINTY/pointer_motion.h \
+    $$POINTY/rate_kalman.h \
+    $$POINTY/sample_block.h \
+    $$POINTY/session_directory.h \
+    $$POINTY/session_format.h \
+    $$POINTY/session_reader.h \
+    $$POINTY/session_simulation.h \
+    $$POINTY/simd.h \
+    $$POINTY/spatial_sample.h \
+    $$POINTY/tremor_estimator.h
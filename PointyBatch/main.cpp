@@ -0,0 +1,364 @@
+#include "dwell_detector.h"
+#include "filter_bank.h"
+#include "pointer_motion.h"
+#include "prediction_metrics.h"
+#include "session_directory.h"
+#include "session_reader.h"
+#include "session_simulation.h"
+#include "smoothing_metrics.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+/**
+ * \brief Command line options, the defaults match the controls of the Pointy settings tab
+ */
+struct Options
+{
+
+    std::string input;
+    std::string output;
+
+    unsigned int threads = 0;
+
+    PointerSettings pointer;
+    FilterSettings filter;
+    DwellSettings dwell;
+    SimulationScreen screen;
+    OutputSettings cadence;
+
+    bool prediction_report = false;
+
+};
+
+/**
+ * \brief Outcome of processing a single session
+ */
+struct SessionSummary
+{
+
+    std::string name;
+    bool valid = false;
+
+    std::uint64_t samples = 0;
+    std::size_t moves = 0;
+    std::size_t clicks = 0;
+
+    SmoothingMetrics smoothing;
+    PredictionMetrics prediction;
+
+    double duration = 0.0;
+    double elapsed = 0.0;
+
+};
+
+void print_usage()
+{
+    std::printf("Usage: PointyBatch <session directory> <output directory> [options]\n"
+                "\n"
+                "Runs every recorded session (*.pty) through the Pointy motion and dwell logic and writes\n"
+                "<name>.trajectory.csv and <name>.clicks.csv for each session.\n"
+                "\n"
+                "Options:\n"
+                "  --threads <n>         worker threads (default: all cores)\n"
+                "  --deadzone <n>        radial deadzone (deg/s) eased in up to twice its size (default: 1)\n"
+                "  --speed <n>           speed (default: 1)\n"
+                "  --radius <px>         dwell trigger radius (default: 250)\n"
+                "  --trigger-time <ms>   dwell trigger time (default: 1000)\n"
+                "  --click-time <s>      dwell click countdown (default: 2)\n"
+                "  --no-clicking         disable dwell clicking\n"
+                "  --no-horizontal       disable horizontal movement\n"
+                "  --no-vertical         disable vertical movement\n"
+                "  --invert              invert movement\n"
+                "  --min-cutoff <hz>     cursor smoothing cut-off while still, 0 disables (default: 0)\n"
+                "  --beta <n>            cursor smoothing cut-off increase per px/s (default: 0.007)\n"
+                "  --curve <points>      acceleration curve as speed:gain pairs, e.g. 20:0.5,120:2 (default: none)\n"
+                "  --curve-shape <shape> linear or smooth (default: smooth)\n"
+                "  --filter <type>       none, lowpass, notch, average, fir or kalman (default: none)\n"
+                "  --filter-frequency <hz> low-pass cut-off, notch centre or kalman bandwidth (default: 5)\n"
+                "  --filter-length <n>   packets averaged by the moving average (default: 8)\n"
+                "  --filter-taps <file>  FIR taps separated by whitespace or commas\n"
+                "  --tremor-notch        detect a 3-12 Hz tremor and follow it with a notch filter\n"
+                "  --screen <w>x<h>      simulated desktop size (default: 1920x1080)\n"
+                "  --output-rate <hz>    coalesce cursor moves to at most this many per second, 0 moves per packet (default: 0)\n"
+                "  --no-output-prediction do not lead coalesced moves by the time they were held back\n"
+                "  --look-ahead <ms>     extrapolate the angular rate this far ahead, 0 disables (default: 0)\n"
+                "  --prediction-report   report the error of extrapolating the angular rate at 5-50 ms look-aheads\n");
+}
+
+bool parse_filter_type(const std::string& name, FilterType& type)
+{
+    const char* const names[] = { "none", "lowpass", "notch", "average", "fir", "kalman" };
+    for (int i = 0; i < 6; ++i)
+    {
+        if (name == names[i])
+        {
+            type = static_cast<FilterType>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool read_filter_taps(const std::string& path, FilterSettings& filter)
+{
+    std::ifstream stream(path.c_str());
+    if (!stream)
+        return false;
+
+    std::string text((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+    std::replace(text.begin(), text.end(), ',', ' ');
+
+    std::istringstream values(text);
+    filter.tap_count = 0;
+    float tap;
+    while (values >> tap)
+    {
+        if (filter.tap_count == FilterSettings::kMaxTaps)
+            return false;
+        filter.taps[filter.tap_count++] = tap;
+    }
+    return filter.tap_count > 0;
+}
+
+bool parse_options(int argc, char* argv[], Options& options)
+{
+    options.pointer.tolerance = 1;
+    options.pointer.speed = 1;
+    options.pointer.beta = 0.007;
+    options.dwell.radius = 250;
+    options.dwell.trigger_time = 1.0;
+    options.dwell.click_time = 2.0;
+
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if (argument == "--threads" && has_value)
+            options.threads = static_cast<unsigned int>(std::atoi(argv[++i]));
+        else if (argument == "--deadzone" && has_value)
+            options.pointer.tolerance = std::atoi(argv[++i]);
+        else if (argument == "--speed" && has_value)
+            options.pointer.speed = std::atoi(argv[++i]);
+        else if (argument == "--radius" && has_value)
+            options.dwell.radius = std::atoi(argv[++i]);
+        else if (argument == "--trigger-time" && has_value)
+            options.dwell.trigger_time = std::atof(argv[++i]) / 1000.0;
+        else if (argument == "--click-time" && has_value)
+            options.dwell.click_time = std::atof(argv[++i]);
+        else if (argument == "--no-clicking")
+            options.dwell.enabled = false;
+        else if (argument == "--no-horizontal")
+            options.pointer.horizontal = false;
+        else if (argument == "--no-vertical")
+            options.pointer.vertical = false;
+        else if (argument == "--invert")
+            options.pointer.invert = true;
+        else if (argument == "--min-cutoff" && has_value)
+            options.pointer.min_cutoff = std::atof(argv[++i]);
+        else if (argument == "--beta" && has_value)
+            options.pointer.beta = std::atof(argv[++i]);
+        else if (argument == "--curve" && has_value)
+        {
+            if (!parse_curve(argv[++i], options.pointer.ballistics))
+            {
+                std::fprintf(stderr, "Could not read up to %d speed:gain points from %s\n", BallisticsSettings::kMaxPoints, argv[i]);
+                return false;
+            }
+        }
+        else if (argument == "--curve-shape" && has_value)
+        {
+            const std::string shape = argv[++i];
+            if (shape == "linear")
+                options.pointer.ballistics.shape = CurveShape::kLinear;
+            else if (shape == "smooth")
+                options.pointer.ballistics.shape = CurveShape::kSmooth;
+            else
+                return false;
+        }
+        else if (argument == "--filter" && has_value)
+        {
+            if (!parse_filter_type(argv[++i], options.filter.type))
+                return false;
+        }
+        else if (argument == "--filter-frequency" && has_value)
+            options.filter.frequency = std::atof(argv[++i]);
+        else if (argument == "--filter-length" && has_value)
+            options.filter.length = std::atoi(argv[++i]);
+        else if (argument == "--filter-taps" && has_value)
+        {
+            if (!read_filter_taps(argv[++i], options.filter))
+            {
+                std::fprintf(stderr, "Could not read up to %d filter taps from %s\n", FilterSettings::kMaxTaps, argv[i]);
+                return false;
+            }
+        }
+        else if (argument == "--tremor-notch")
+            options.filter.tremor_notch = true;
+        else if (argument == "--screen" && has_value)
+        {
+            if (std::sscanf(argv[++i], "%dx%d", &options.screen.width, &options.screen.height) != 2)
+                return false;
+        }
+        else if (argument == "--output-rate" && has_value)
+            options.cadence.rate = std::atof(argv[++i]);
+        else if (argument == "--no-output-prediction")
+            options.cadence.prediction = false;
+        else if (argument == "--look-ahead" && has_value)
+            options.pointer.look_ahead = std::atof(argv[++i]) / 1000.0;
+        else if (argument == "--prediction-report")
+            options.prediction_report = true;
+        else if (argument.compare(0, 2, "--") == 0)
+            return false;
+        else
+            positional.push_back(argument);
+    }
+
+    if (positional.size() != 2)
+        return false;
+
+    options.input = positional[0];
+    options.output = positional[1];
+
+    if (options.threads == 0)
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+    return true;
+}
+
+void write_points(const std::string& path, const std::vector<TrajectoryPoint>& points)
+{
+    std::ofstream stream(path.c_str());
+    stream << "timestamp,x,y\n";
+    for (const TrajectoryPoint& point : points)
+        stream << point.timestamp << "," << point.x << "," << point.y << "\n";
+}
+
+SessionSummary process_session(const std::string& path, const Options& options)
+{
+    SessionSummary summary;
+    summary.name = session_name(path);
+
+    const auto start = std::chrono::steady_clock::now();
+
+    SessionReader session;
+    if (!session.open(path))
+        return summary;
+
+    SimulationResult result = simulate_session(session, options.pointer, options.filter, options.dwell, options.screen, options.cadence);
+
+    // Smoothing, prediction and coalescing are measured against the same session replayed without them
+    PointerSettings raw_pointer = options.pointer;
+    raw_pointer.min_cutoff = 0.0;
+    raw_pointer.look_ahead = 0.0;
+    const bool raw_differs = options.pointer.min_cutoff > 0.0 || options.pointer.look_ahead > 0.0 || options.cadence.rate > 0.0;
+    const SimulationResult raw = raw_differs ? simulate_session(session, raw_pointer, options.filter, options.dwell, options.screen, OutputSettings()) : result;
+    summary.smoothing = measure_smoothing(result, raw);
+
+    if (options.prediction_report)
+        summary.prediction = measure_prediction(session, options.filter);
+
+    summary.elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    summary.valid = true;
+    summary.samples = result.samples;
+    summary.moves = result.trajectory.size();
+    summary.clicks = result.clicks.size();
+    summary.duration = session.duration();
+
+    write_points(options.output + "/" + summary.name + ".trajectory.csv", result.trajectory);
+    write_points(options.output + "/" + summary.name + ".clicks.csv", result.clicks);
+    return summary;
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parse_options(argc, argv, options))
+    {
+        print_usage();
+        return 1;
+    }
+
+    const std::vector<std::string> sessions = list_sessions(options.input);
+    if (sessions.empty())
+    {
+        std::fprintf(stderr, "No sessions found in %s\n", options.input.c_str());
+        return 1;
+    }
+
+    std::vector<SessionSummary> summaries(sessions.size());
+    std::atomic<std::size_t> next(0);
+
+    // Sessions are handed out one at a time so long recordings do not hold up an entire shard
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    const unsigned int threads = std::min<unsigned int>(options.threads, static_cast<unsigned int>(sessions.size()));
+    for (unsigned int t = 0; t < threads; ++t)
+    {
+        workers.push_back(std::thread([&]()
+        {
+            for (std::size_t i = next++; i < sessions.size(); i = next++)
+                summaries[i] = process_session(sessions[i], options);
+        }));
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::uint64_t total_samples = 0;
+    int failures = 0;
+    std::printf("%-32s %12s %10s %8s %8s %10s %10s %8s %14s\n", "session", "samples", "duration", "moves", "clicks", "jitter", "raw jitter", "lag", "samples/s");
+    for (const SessionSummary& summary : summaries)
+    {
+        if (!summary.valid)
+        {
+            std::printf("%-32s unreadable\n", summary.name.c_str());
+            ++failures;
+            continue;
+        }
+        total_samples += summary.samples;
+        std::printf("%-32s %12llu %9.1fs %8zu %8zu %6.1fpx/s %6.1fpx/s %6.0fms %14.0f\n", summary.name.c_str(), static_cast<unsigned long long>(summary.samples),
+                    summary.duration, summary.moves, summary.clicks, summary.smoothing.jitter, summary.smoothing.raw_jitter, summary.smoothing.lag * 1000.0,
+                    summary.elapsed > 0.0 ? summary.samples / summary.elapsed : 0.0);
+    }
+
+    std::printf("\n%zu sessions, %llu samples in %.3fs on %u threads (%.0f samples/s)\n", sessions.size(),
+                static_cast<unsigned long long>(total_samples), elapsed, threads, elapsed > 0.0 ? total_samples / elapsed : 0.0);
+
+    // Prediction is reported across every session, while the head is moving
+    if (options.prediction_report)
+    {
+        PredictionMetrics prediction;
+        for (const SessionSummary& summary : summaries)
+            prediction.add(summary.prediction);
+
+        std::printf("\n%-12s %12s %12s %10s %10s\n", "look-ahead", "held", "predicted", "reduction", "packets");
+        for (int k = 0; k < PredictionMetrics::kLookAheads; ++k)
+        {
+            const double count = static_cast<double>(std::max<std::uint64_t>(prediction.count[k], 1));
+            const double held = std::sqrt(prediction.held_error[k] / count);
+            const double predicted = std::sqrt(prediction.predicted_error[k] / count);
+            std::printf("%10.0fms %7.2fdeg/s %7.2fdeg/s %9.0f%% %10llu\n", PredictionMetrics::look_ahead(k) * 1000.0, held, predicted,
+                        held > 0.0 ? 100.0 * (held - predicted) / held : 0.0, static_cast<unsigned long long>(prediction.count[k]));
+        }
+    }
+
+    return failures > 0 ? 2 : 0;
+}
@@ -0,0 +1,157 @@
+#include "prediction_metrics.h"
+#include "gyro_bias_estimator.h"
+#include "rate_kalman.h"
+#include "sample_block.h"
+#include <cmath>
+#include <vector>
+
+const double PredictionMetrics::kLookAheadStep = 0.005;
+
+namespace
+{
+
+// The head is moving while its angular speed across both axes exceeds this (degrees per second)
+const double kMovingSpeed = 5.0;
+
+// Gaps between packets longer than this (seconds) are treated as a restart of the stream
+const double kMaxSampleInterval = 0.25;
+
+/**
+ * \brief Measured angular rate of both pointer axes at a packet and the filters tracking them
+ */
+struct RatePoint
+{
+    double timestamp;
+    double measured_x;
+    double measured_y;
+    RateKalman kalman_x;
+    RateKalman kalman_y;
+};
+
+/**
+ * \brief Returns the squared length of the difference between two rates across both axes
+ */
+double squared_error(const double& x, const double& y, const double& expected_x, const double& expected_y)
+{
+    return (x - expected_x) * (x - expected_x) + (y - expected_y) * (y - expected_y);
+}
+
+}
+
+/**
+ * \brief Adds the errors of another session
+ */
+void PredictionMetrics::add(const PredictionMetrics& other)
+{
+    for (int i = 0; i < kLookAheads; ++i)
+    {
+        held_error[i] += other.held_error[i];
+        predicted_error[i] += other.predicted_error[i];
+        count[i] += other.count[i];
+    }
+}
+
+/**
+ * \brief Returns the look-ahead (seconds) of a row
+ */
+double PredictionMetrics::look_ahead(const int& index)
+{
+    return (index + 1) * kLookAheadStep;
+}
+
+/**
+ * \brief Measures the error of predicting a session's angular rate at each look-ahead
+ * \param session recorded session
+ * \param filter_settings filter bank parameters, the sample rate is measured from the session
+ */
+PredictionMetrics measure_prediction(const SessionReader& session, const FilterSettings& filter_settings)
+{
+    PredictionMetrics metrics;
+
+    GyroBiasEstimator bias;
+
+    FilterSettings filter_design = filter_settings;
+    if (session.record_count() > 1 && session.duration() > 0.0)
+    {
+        filter_design.sample_rate = (session.record_count() - 1) / session.duration();
+    }
+    FilterBank filter;
+    filter.set_settings(filter_design);
+
+    // The rate is corrected and filtered as by the live pointer, then tracked by a filter per axis
+    RateKalman kalman_x;
+    RateKalman kalman_y;
+    std::vector<RatePoint> points;
+    points.reserve(session.record_count());
+
+    SampleBlock block;
+    for (std::size_t c = 0; c < session.chunk_count(); ++c)
+    {
+        const SessionChunk& chunk = session.chunk(c);
+        for (std::uint32_t r = 0; r < chunk.count; r += SampleBlock::kCapacity)
+        {
+            block.clear();
+            for (std::uint32_t i = r; i < chunk.count && !block.full(); ++i)
+            {
+                block.push(to_spatial_sample(chunk.records[i]));
+            }
+            bias.update(block);
+            bias.correct(block);
+            filter.set_rate_noise(bias.noise());
+            filter.process(block);
+
+            for (std::size_t i = 0; i < block.count; ++i)
+            {
+                const SpatialSample sample = block.sample(i);
+                const double dt = points.empty() ? 0.0 : sample.timestamp - points.back().timestamp;
+                const double interval = dt <= kMaxSampleInterval ? dt : 0.0;
+                kalman_x.update(sample.angular_rate.z, interval);
+                kalman_y.update(sample.angular_rate.x, interval);
+                points.push_back(RatePoint{ sample.timestamp, sample.angular_rate.z, sample.angular_rate.x, kalman_x, kalman_y });
+            }
+        }
+    }
+
+    for (int k = 0; k < PredictionMetrics::kLookAheads; ++k)
+    {
+        const double look_ahead = PredictionMetrics::look_ahead(k);
+        std::size_t next = 0;
+        for (std::size_t i = 0; i < points.size(); ++i)
+        {
+            // Find the packets either side of the predicted time
+            const RatePoint& point = points[i];
+            const double target = point.timestamp + look_ahead;
+            while (next < points.size() && points[next].timestamp < target)
+            {
+                ++next;
+            }
+            if (next == points.size())
+            {
+                break;
+            }
+
+            const RatePoint& before = points[next - 1];
+            const RatePoint& after = points[next];
+            if (after.timestamp - before.timestamp > kMaxSampleInterval)
+            {
+                continue;
+            }
+            const double weight = (target - before.timestamp) / (after.timestamp - before.timestamp);
+            const double actual_x = before.measured_x + weight * (after.measured_x - before.measured_x);
+            const double actual_y = before.measured_y + weight * (after.measured_y - before.measured_y);
+
+            const double rate_x = point.kalman_x.rate();
+            const double rate_y = point.kalman_y.rate();
+            if (std::hypot(rate_x, rate_y) < kMovingSpeed && std::hypot(actual_x, actual_y) < kMovingSpeed)
+            {
+                continue;
+            }
+
+            metrics.held_error[k] += squared_error(rate_x, rate_y, actual_x, actual_y);
+            metrics.predicted_error[k] += squared_error(point.kalman_x.predict(look_ahead), point.kalman_y.predict(look_ahead), actual_x, actual_y);
+            ++metrics.count[k];
+        }
+    }
+
+    return metrics;
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include <cstdint>
+#include "filter_bank.h"
+#include "session_reader.h"
+
+/**
+ * \brief Error of the angular rate extrapolated by the RateKalman over a range of look-aheads
+ *
+ * A session is replayed through the bias correction and filter bank of the live pointer and the
+ * rate of each packet is predicted ahead by every look-ahead, then compared with the rate the
+ * session actually reached by then, interpolated between packets. Holding the filtered rate is the
+ * baseline, it is what the cursor sees without prediction. Only packets where the head is moving,
+ * now or at the predicted time, are counted, the error at rest is the sensor's noise either way.
+ */
+struct PredictionMetrics
+{
+
+    static const int kLookAheads = 10;
+
+    // Spacing of the look-aheads (seconds), the first is one step
+    static const double kLookAheadStep;
+
+    // Squared error across both axes of holding and of predicting the rate ((degrees per second)^2)
+    double held_error[kLookAheads] = {};
+    double predicted_error[kLookAheads] = {};
+    std::uint64_t count[kLookAheads] = {};
+
+    void add(const PredictionMetrics& other);
+
+    static double look_ahead(const int& index);
+
+};
+
+PredictionMetrics measure_prediction(const SessionReader& session, const FilterSettings& filter_settings);
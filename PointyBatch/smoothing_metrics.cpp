@@ -0,0 +1,128 @@
+#include "smoothing_metrics.h"
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace
+{
+
+// Interval at which the trajectories are sampled (seconds)
+const double kSampleInterval = 0.01;
+
+// The unsmoothed cursor is resting while it travels slower than this (pixels per second) over
+// kRestWindow samples either side
+const double kRestSpeed = 30.0;
+const int kRestWindow = 10;
+
+// Longest delay considered when aligning the trajectories (samples)
+const int kMaxLag = 50;
+
+struct Point
+{
+    double x;
+    double y;
+};
+
+/**
+ * \brief Samples a trajectory's cursor position every kSampleInterval from start
+ */
+std::vector<Point> sample_trajectory(const std::vector<TrajectoryPoint>& trajectory, const double& start, const std::size_t& count)
+{
+    std::vector<Point> points(count);
+    std::size_t next = 0;
+    Point position = { static_cast<double>(trajectory.front().x), static_cast<double>(trajectory.front().y) };
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const double time = start + i * kSampleInterval;
+        for (; next < trajectory.size() && trajectory[next].timestamp <= time; ++next)
+        {
+            position.x = trajectory[next].x;
+            position.y = trajectory[next].y;
+        }
+        points[i] = position;
+    }
+    return points;
+}
+
+double distance(const Point& a, const Point& b)
+{
+    return std::hypot(b.x - a.x, b.y - a.y);
+}
+
+/**
+ * \brief Returns the average speed (pixels per second) of a sampled trajectory over the resting samples
+ */
+double resting_speed(const std::vector<Point>& points, const std::vector<bool>& resting)
+{
+    double travelled = 0.0;
+    std::size_t count = 0;
+    for (std::size_t i = 1; i < points.size(); ++i)
+    {
+        if (resting[i])
+        {
+            travelled += distance(points[i - 1], points[i]);
+            ++count;
+        }
+    }
+    return count > 0 ? travelled / (count * kSampleInterval) : 0.0;
+}
+
+}
+
+/**
+ * \brief Measures the jitter and lag of a smoothed session
+ * \param smoothed session simulated with smoothing
+ * \param raw the same session simulated without smoothing
+ */
+SmoothingMetrics measure_smoothing(const SimulationResult& smoothed, const SimulationResult& raw)
+{
+    SmoothingMetrics metrics;
+    if (smoothed.trajectory.empty() || raw.trajectory.empty())
+    {
+        return metrics;
+    }
+
+    const double start = raw.trajectory.front().timestamp;
+    const double end = std::max(raw.trajectory.back().timestamp, smoothed.trajectory.back().timestamp);
+    const std::size_t count = static_cast<std::size_t>((end - start) / kSampleInterval) + 1;
+
+    const std::vector<Point> smoothed_points = sample_trajectory(smoothed.trajectory, start, count);
+    const std::vector<Point> raw_points = sample_trajectory(raw.trajectory, start, count);
+
+    std::vector<bool> resting(count, false);
+    for (std::size_t i = kRestWindow; i + kRestWindow < count; ++i)
+    {
+        resting[i] = distance(raw_points[i - kRestWindow], raw_points[i + kRestWindow]) < kRestSpeed * 2 * kRestWindow * kSampleInterval;
+    }
+
+    metrics.jitter = resting_speed(smoothed_points, resting);
+    metrics.raw_jitter = resting_speed(raw_points, resting);
+
+    // Find the delay that best aligns the movement of the trajectories. Movement over a window is
+    // compared rather than position, the trajectories drift apart wherever the cursor meets the
+    // edge of the screen.
+    double best_error = -1.0;
+    for (int lag = 0; lag <= kMaxLag; ++lag)
+    {
+        double error = 0.0;
+        for (std::size_t i = kRestWindow + lag; i + kRestWindow < count; ++i)
+        {
+            if (!resting[i - lag])
+            {
+                const Point smoothed_movement = { smoothed_points[i + kRestWindow].x - smoothed_points[i - kRestWindow].x,
+                                                  smoothed_points[i + kRestWindow].y - smoothed_points[i - kRestWindow].y };
+                const Point raw_movement = { raw_points[i - lag + kRestWindow].x - raw_points[i - lag - kRestWindow].x,
+                                             raw_points[i - lag + kRestWindow].y - raw_points[i - lag - kRestWindow].y };
+                const double d = distance(smoothed_movement, raw_movement);
+                error += d * d;
+            }
+        }
+        if (best_error < 0.0 || error < best_error)
+        {
+            best_error = error;
+            metrics.lag = lag * kSampleInterval;
+        }
+    }
+
+    return metrics;
+}
@@ -0,0 +1,24 @@
+#pragma once
+#include "session_simulation.h"
+
+/**
+ * \brief Jitter and lag of a simulated session's cursor, measured against the same session
+ * replayed without smoothing
+ *
+ * Both trajectories are sampled at a fixed rate. Jitter is the average speed of the cursor while
+ * the unsmoothed cursor is resting, lag is the delay that best aligns the smoothed trajectory with
+ * the unsmoothed one while it is moving.
+ */
+struct SmoothingMetrics
+{
+
+    // Average cursor speed while resting (pixels per second), with and without smoothing
+    double jitter = 0.0;
+    double raw_jitter = 0.0;
+
+    // Delay of the smoothed cursor (seconds)
+    double lag = 0.0;
+
+};
+
+SmoothingMetrics measure_smoothing(const SimulationResult& smoothed, const SimulationResult& raw);
@@ -0,0 +1,52 @@
+#-------------------------------------------------
+#
+# Throughput benchmarks of the Pointy math and pipeline stages
+#
+#-------------------------------------------------
+
+QT       -= core gui
+CONFIG   += console c++11 release
+CONFIG   -= app_bundle qt
+
+TARGET = PointyBench
+
+TEMPLATE = app
+
+POINTY = $$_PRO_FILE_PWD_/../SpatialPointer
+
+INCLUDEPATH += $$POINTY
+
+# Let the batch kernels use every instruction set of the machine running the benchmark
+!win32-msvc*: QMAKE_CXXFLAGS += -march=native
+win32-msvc*: QMAKE_CXXFLAGS += /arch:AVX
+
+SOURCES += main.cpp \
+    $$POINTY/ballistics_curve.cpp \
+    $$POINTY/block_kernels.cpp \
+    $$POINTY/filter_bank.cpp \
+    $$POINTY/gyro_bias_estimator.cpp \
+    $$POINTY/one_euro_filter.cpp \
+    $$POINTY/orientation_filter.cpp \
+    $$POINTY/output_coalescer.cpp \
+    $$POINTY/pointer_motion.cpp \
+    $$POINTY/rate_kalman.cpp \
+    $$POINTY/sample_block.cpp \
+    $$POINTY/tremor_estimator.cpp \
+    $$POINTY/vector_kernels.cpp
+
+HEADERS += \
+    $$POINTY/ballistics_curve.h \
+    $$POINTY/block_kernels.h \
+    $$POINTY/filter_bank.h \
+    $$POINTY/gyro_bias_estimator.h \
+    $$POINTY/linear_algebra.h \
+    $$POINTY/one_euro_filter.h \
+    $$POINTY/orientation_filter.h \
+    $$POINTY/output_coalescer.h \
+    $$POINTY/pointer_motion.h \
+    $$POINTY/rate_kalman.h \
+    $$POINTY/sample_block.h \
+    $$POINTY/simd.h \
+    $$POINTY/spatial_sample.h \
+    $$POINTY/tremor_estimator.h \
+    $$POINTY/vector_kernels.h
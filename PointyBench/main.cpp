@@ -0,0 +1,494 @@
+#include "block_kernels.h"
+#include "filter_bank.h"
+#include "gyro_bias_estimator.h"
+#include "linear_algebra.h"
+#include "orientation_filter.h"
+#include "pointer_motion.h"
+#include "sample_block.h"
+#include "vector_kernels.h"
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+namespace
+{
+
+// Vectors per kernel call, small enough to stay in the first level caches like a burst of packets
+const std::size_t kBatchSize = 4096;
+
+// Packets per pipeline stage run
+const std::size_t kStreamLength = 1 << 20;
+
+// Minimum time spent on each measurement (seconds)
+const double kMinimumDuration = 0.25;
+
+// Minimum time between reads of the clock while measuring (seconds)
+const double kMinimumRound = 0.001;
+
+const double kDataRate = 250.0;
+
+// Packets of white noise the filters' attenuation is measured over, and those left out while they settle
+const std::size_t kNoiseLength = 1 << 16;
+const std::size_t kNoiseSettle = 1024;
+
+// Accumulates results so that the compiler cannot discard the work being measured
+double sink = 0.0;
+
+/**
+ * \brief Repeats an operation on items elements until kMinimumDuration has passed
+ * \return time per element (nanoseconds)
+ *
+ * The clock is read once per round of repetitions, and rounds are lengthened until one lasts at
+ * least kMinimumRound, so reading the clock costs nothing measurable even for the smallest kernels.
+ */
+template<class Operation>
+double measure(const std::size_t& items, const Operation& operation)
+{
+    typedef std::chrono::steady_clock Clock;
+
+    // Warm up the caches and branch predictors
+    operation();
+
+    std::size_t round = 1;
+    std::size_t repetitions = 0;
+    const Clock::time_point start = Clock::now();
+    Clock::time_point round_start = start;
+    double elapsed = 0.0;
+    do
+    {
+        for (std::size_t i = 0; i < round; ++i)
+            operation();
+        repetitions += round;
+
+        const Clock::time_point now = Clock::now();
+        if (std::chrono::duration<double>(now - round_start).count() < kMinimumRound)
+            round *= 2;
+        round_start = now;
+        elapsed = std::chrono::duration<double>(now - start).count();
+    } while (elapsed < kMinimumDuration);
+
+    return elapsed * 1.0e9 / (static_cast<double>(repetitions) * items);
+}
+
+void print_header(const char* title)
+{
+    std::printf("\n%-30s %12s %12s %9s\n", title, "scalar", "batch", "speedup");
+}
+
+void print_comparison(const char* name, const double& scalar, const double& batch)
+{
+    std::printf("%-30s %9.3f ns %9.3f ns %8.2fx\n", name, scalar, batch, scalar / batch);
+}
+
+void print_scalar(const char* name, const double& scalar)
+{
+    std::printf("%-30s %9.3f ns %12s %9s\n", name, scalar, "-", "-");
+}
+
+void print_rate(const char* name, const double& nanoseconds)
+{
+    std::printf("%-30s %9.1f ns %9.2f M/s %8.0fx\n", name, nanoseconds, 1.0e3 / nanoseconds, 1.0e9 / (nanoseconds * kDataRate));
+}
+
+void print_attenuation(const char* name, const double& ratio)
+{
+    std::printf("  %-28s %9.3f of the input noise\n", name, ratio);
+}
+
+/**
+ * \brief Compares the batch kernels against straightforward loops over the same data
+ */
+template<class T>
+void benchmark_kernels(const char* title)
+{
+    std::mt19937 generator(1);
+    std::uniform_real_distribution<T> distribution(-100, 100);
+
+    std::vector<Vec3<T>> vectors(kBatchSize);
+    for (Vec3<T>& vector : vectors)
+        vector = Vec3<T>(distribution(generator), distribution(generator), distribution(generator));
+
+    std::vector<Vec3<T>> output(kBatchSize);
+    std::vector<T> lengths(kBatchSize);
+
+    const Vec3<T> offset(T(0.5), T(-0.25), T(0.125));
+    const Mat3<T> rotation = normalized(Quat<T>(T(0.9), T(0.1), T(-0.3), T(0.2))).to_matrix();
+
+    print_header(title);
+
+    // Alternating signs keep the values bounded however many times the operation repeats
+    T sign = 1;
+    const double add_scalar = measure(kBatchSize, [&]()
+    {
+        const Vec3<T> step = offset * sign;
+        for (Vec3<T>& vector : vectors)
+            vector += step;
+        sign = -sign;
+    });
+    const double add_batch = measure(kBatchSize, [&]()
+    {
+        batch_add(vectors.data(), vectors.size(), offset * sign);
+        sign = -sign;
+    });
+    print_comparison("add", add_scalar, add_batch);
+
+    const double scale_scalar = measure(kBatchSize, [&]()
+    {
+        const T factor = sign > 0 ? T(2) : T(0.5);
+        for (Vec3<T>& vector : vectors)
+            vector *= factor;
+        sign = -sign;
+    });
+    const double scale_batch = measure(kBatchSize, [&]()
+    {
+        batch_scale(vectors.data(), vectors.size(), sign > 0 ? T(2) : T(0.5));
+        sign = -sign;
+    });
+    print_comparison("scale", scale_scalar, scale_batch);
+
+    const double length_scalar = measure(kBatchSize, [&]()
+    {
+        for (std::size_t i = 0; i < vectors.size(); ++i)
+            lengths[i] = length(vectors[i]);
+        sink += lengths[kBatchSize / 2];
+    });
+    const double length_batch = measure(kBatchSize, [&]()
+    {
+        batch_length(vectors.data(), vectors.size(), lengths.data());
+        sink += lengths[kBatchSize / 2];
+    });
+    print_comparison("length", length_scalar, length_batch);
+
+    const double transform_scalar = measure(kBatchSize, [&]()
+    {
+        for (std::size_t i = 0; i < vectors.size(); ++i)
+            output[i] = rotation * vectors[i];
+        sink += output[kBatchSize / 2].x;
+    });
+    const double transform_batch = measure(kBatchSize, [&]()
+    {
+        batch_transform(rotation, vectors.data(), output.data(), vectors.size());
+        sink += output[kBatchSize / 2].x;
+    });
+    print_comparison("transform", transform_scalar, transform_batch);
+
+    // Quaternion rotation of each vector, the alternative to converting to a matrix once, compare it
+    // with the scalar transform above as there is no batch kernel for it
+    const Quat<T> quaternion = normalized(Quat<T>(T(0.9), T(0.1), T(-0.3), T(0.2)));
+    const double rotate_scalar = measure(kBatchSize, [&]()
+    {
+        for (std::size_t i = 0; i < vectors.size(); ++i)
+            output[i] = quaternion.rotate(vectors[i]);
+        sink += output[kBatchSize / 2].x;
+    });
+    print_scalar("quaternion rotate", rotate_scalar);
+}
+
+/**
+ * \brief Compares the block kernels against straightforward loops over one channel of a block
+ */
+void benchmark_block_kernels()
+{
+    std::mt19937 generator(3);
+    std::uniform_real_distribution<float> distribution(-100.0f, 100.0f);
+
+    const std::size_t count = SampleBlock::kCapacity;
+    float x[SampleBlock::kCapacity];
+    float y[SampleBlock::kCapacity];
+    float z[SampleBlock::kCapacity];
+    float output[SampleBlock::kCapacity];
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        x[i] = distribution(generator);
+        y[i] = distribution(generator);
+        z[i] = distribution(generator);
+    }
+
+    print_header("Block kernels (per value)");
+
+    const double length_scalar = measure(count, [&]()
+    {
+        for (std::size_t i = 0; i < count; ++i)
+            output[i] = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+        sink += output[count / 2];
+    });
+    const double length_block = measure(count, [&]()
+    {
+        block_length(x, y, z, count, output);
+        sink += output[count / 2];
+    });
+    print_comparison("length", length_scalar, length_block);
+
+    const double moments_scalar = measure(count, [&]()
+    {
+        double sum = 0.0;
+        double square_sum = 0.0;
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            const double value = x[i];
+            sum += value;
+            square_sum += value * value;
+        }
+        sink += sum + square_sum;
+    });
+    const double moments_block = measure(count, [&]()
+    {
+        double sum = 0.0;
+        double square_sum = 0.0;
+        block_moments(x, count, sum, square_sum);
+        sink += sum + square_sum;
+    });
+    print_comparison("moments", moments_scalar, moments_block);
+
+    const double dot_scalar = measure(count, [&]()
+    {
+        double sum = 0.0;
+        for (std::size_t i = 0; i < count; ++i)
+            sum += static_cast<double>(x[i]) * y[i];
+        sink += sum;
+    });
+    const double dot_block = measure(count, [&]()
+    {
+        sink += block_dot(x, y, count);
+    });
+    print_comparison("dot", dot_scalar, dot_block);
+}
+
+/**
+ * \brief Generates a stream of head movement with noise and a gyroscope bias, the same shape as
+ * the simulated PhidgetSpatial
+ */
+std::vector<SpatialSample> make_stream()
+{
+    std::mt19937 generator(2);
+    std::normal_distribution<double> noise(0.0, 0.1);
+
+    std::vector<SpatialSample> stream(kStreamLength);
+    for (std::size_t i = 0; i < stream.size(); ++i)
+    {
+        const double time = i / kDataRate;
+        const double phase = 2.0 * 3.14159265358979323846 * 0.25 * time;
+
+        SpatialSample& sample = stream[i];
+        sample.timestamp = time;
+        sample.angular_rate = Vec3d(30.0 * std::cos(phase) + 0.5 + noise(generator), noise(generator), 30.0 * std::sin(phase) - 0.3 + noise(generator));
+        sample.acceleration = Vec3d(0.01 * noise(generator), 0.01 * noise(generator), -1.0 + 0.01 * noise(generator));
+        sample.magnetic_field = Vec3d(0.2 + 0.01 * noise(generator), 0.01 * noise(generator), -0.4 + 0.01 * noise(generator));
+    }
+    return stream;
+}
+
+/**
+ * \brief Splits a stream into full blocks, as the pipeline receives it from a busy queue
+ */
+std::vector<SampleBlock> make_blocks(const std::vector<SpatialSample>& stream)
+{
+    std::vector<SampleBlock> blocks(1);
+    for (const SpatialSample& sample : stream)
+    {
+        if (blocks.back().full())
+            blocks.emplace_back();
+        blocks.back().push(sample);
+    }
+    return blocks;
+}
+
+/**
+ * \brief Returns the standard deviation of the angular rate leaving the filter bank over that of
+ * white noise entering it, the gyroscope's noise being measured at the same variance
+ * \param filter filter bank with the settings to measure, it is reset
+ * \param variance variance of the noise ((degrees per second)^2)
+ */
+double noise_passed(FilterBank& filter, const double& variance)
+{
+    std::mt19937 generator(4);
+    std::normal_distribution<double> noise(0.0, std::sqrt(variance));
+
+    filter.reset();
+    filter.set_rate_noise(Vec3d(variance, variance, variance));
+
+    double input = 0.0;
+    double output = 0.0;
+    SampleBlock block;
+    for (std::size_t i = 0; i < kNoiseLength; i += SampleBlock::kCapacity)
+    {
+        block.clear();
+        for (std::size_t j = i; !block.full(); ++j)
+        {
+            SpatialSample sample;
+            sample.timestamp = j / kDataRate;
+            sample.angular_rate = Vec3d(noise(generator), 0.0, 0.0);
+            block.push(sample);
+        }
+
+        const float* rates = block.channels[SampleBlock::kAngularRateX];
+        if (i < kNoiseSettle)
+        {
+            filter.process(block);
+            continue;
+        }
+
+        for (std::size_t j = 0; j < block.count; ++j)
+        {
+            input += static_cast<double>(rates[j]) * rates[j];
+        }
+        filter.process(block);
+        for (std::size_t j = 0; j < block.count; ++j)
+        {
+            output += static_cast<double>(rates[j]) * rates[j];
+        }
+    }
+
+    filter.set_rate_noise(Vec3d());
+    return std::sqrt(output / input);
+}
+
+/**
+ * \brief Measures the cost per packet of each stage of the pointer pipeline
+ */
+void benchmark_pipeline()
+{
+    const std::vector<SpatialSample> stream = make_stream();
+    const std::vector<SampleBlock> blocks = make_blocks(stream);
+
+    std::printf("\n%-30s %12s %12s %9s\n", "Pipeline stage (per packet)", "time", "rate", "headroom");
+
+    GyroBiasEstimator bias;
+    print_rate("gyro bias estimation", measure(stream.size(), [&]()
+    {
+        bias.reset();
+        for (SampleBlock block : blocks)
+        {
+            bias.update(block);
+            bias.correct(block);
+            sink += block.channels[SampleBlock::kAngularRateX][0];
+        }
+    }));
+
+    // Filters run over all nine channels, the cost is per packet rather than per channel
+    FilterSettings filter_settings;
+    filter_settings.sample_rate = kDataRate;
+    FilterBank filter;
+    const auto filter_stage = [&]()
+    {
+        filter.reset();
+        for (SampleBlock block : blocks)
+        {
+            filter.process(block);
+            sink += block.channels[SampleBlock::kAngularRateX][0];
+        }
+    };
+
+    filter_settings.type = FilterType::kLowPass;
+    filter.set_settings(filter_settings);
+    print_rate("low-pass filter bank", measure(stream.size(), filter_stage));
+    print_attenuation("noise passed", noise_passed(filter, 0.1));
+
+    filter_settings.type = FilterType::kFir;
+    filter_settings.tap_count = 16;
+    for (int i = 0; i < filter_settings.tap_count; ++i)
+        filter_settings.taps[i] = 1.0f / filter_settings.tap_count;
+    filter.set_settings(filter_settings);
+    print_rate("16 tap fir filter bank", measure(stream.size(), filter_stage));
+
+    filter_settings.type = FilterType::kKalman;
+    filter.set_settings(filter_settings);
+    print_rate("kalman rate estimator", measure(stream.size(), filter_stage));
+    print_attenuation("noise passed, typical gyro", noise_passed(filter, 0.1));
+    print_attenuation("noise passed, quiet gyro", noise_passed(filter, 0.01));
+
+    filter_settings.type = FilterType::kNone;
+    filter_settings.tremor_notch = true;
+    filter.set_settings(filter_settings);
+    print_rate("tremor estimator and notch", measure(stream.size(), filter_stage));
+
+    OrientationSettings settings;
+    OrientationFilter orientation;
+
+    settings.algorithm = FusionAlgorithm::kMadgwick;
+    orientation.set_settings(settings);
+    print_rate("madgwick fusion", measure(stream.size(), [&]()
+    {
+        orientation.reset();
+        for (const SpatialSample& sample : stream)
+            orientation.update(sample);
+        sink += orientation.orientation().w;
+    }));
+
+    settings.algorithm = FusionAlgorithm::kMahony;
+    orientation.set_settings(settings);
+    print_rate("mahony fusion", measure(stream.size(), [&]()
+    {
+        orientation.reset();
+        for (const SpatialSample& sample : stream)
+            orientation.update(sample);
+        sink += orientation.orientation().w;
+    }));
+
+    PointerSettings pointer_settings;
+    pointer_settings.tolerance = 1;
+    pointer_settings.speed = 1;
+    PointerMotion motion;
+    motion.set_settings(pointer_settings);
+    print_rate("relative motion", measure(stream.size(), [&]()
+    {
+        motion.reset();
+        int x = 0;
+        int y = 0;
+        for (const SpatialSample& sample : stream)
+        {
+            motion.integrate(sample);
+            int displacement_x;
+            int displacement_y;
+            motion.take_pixels(displacement_x, displacement_y);
+            x += displacement_x;
+            y += displacement_y;
+        }
+        sink += x + y;
+    }));
+
+    const auto block_motion_stage = [&]()
+    {
+        motion.reset();
+        int x = 0;
+        int y = 0;
+        for (const SampleBlock& block : blocks)
+        {
+            motion.integrate(block);
+            int displacement_x;
+            int displacement_y;
+            motion.take_pixels(displacement_x, displacement_y);
+            x += displacement_x;
+            y += displacement_y;
+        }
+        sink += x + y;
+    };
+
+    print_rate("relative motion, blocks", measure(stream.size(), block_motion_stage));
+
+    parse_curve("5:0.5,40:1,150:3", pointer_settings.ballistics);
+    motion.set_settings(pointer_settings);
+    print_rate("accelerated motion, blocks", measure(stream.size(), block_motion_stage));
+
+    pointer_settings.ballistics = BallisticsSettings();
+    pointer_settings.look_ahead = 0.02;
+    motion.set_settings(pointer_settings);
+    print_rate("predicted motion, blocks", measure(stream.size(), block_motion_stage));
+}
+
+}
+
+int main()
+{
+    std::printf("Batch kernels compiled for %s\n", batch_instruction_set());
+
+    benchmark_kernels<float>("Kernels, float (per vector)");
+    benchmark_kernels<double>("Kernels, double (per vector)");
+    benchmark_block_kernels();
+    benchmark_pipeline();
+
+    std::printf("\nHeadroom is the multiple of a %.0f Hz data rate a single core could sustain (checksum %g)\n", kDataRate, sink);
+    return 0;
+}
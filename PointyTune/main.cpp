@@ -0,0 +1,359 @@
+#include "session_directory.h"
+#include "session_reader.h"
+#include "session_simulation.h"
+#include "trajectory_score.h"
+#include "work_stealing_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+
+enum class Search
+{
+    kGrid,
+    kRandom,
+    kRefine
+};
+
+struct Options
+{
+
+    std::string input;
+    std::string report;
+
+    Search search = Search::kGrid;
+    std::size_t samples = 2000;
+    std::size_t top = 10;
+    unsigned int threads = 0;
+    unsigned int seed = 1;
+
+    SimulationScreen screen;
+    ScoreWeights weights;
+
+};
+
+/**
+ * \brief A single configuration and its score over every session
+ */
+struct Candidate
+{
+
+    PointerSettings pointer;
+    DwellSettings dwell;
+
+    TrajectoryScore score;
+    double value = 0.0;
+
+};
+
+// Search space, the ranges match the limits of the Pointy settings tab controls
+const int kDeadzoneMin = 0;
+const int kDeadzoneMax = 100;
+const int kSpeedMin = 1;
+const int kSpeedMax = 10;
+const int kRadiusMin = 1;
+const int kRadiusMax = 960;
+const double kTriggerTimeMin = 0.5;
+const double kTriggerTimeMax = 10.0;
+const int kClickTimeMin = 1;
+const int kClickTimeMax = 10;
+
+const int kGridDeadzone[] = { 0, 1, 2, 3, 5, 8, 12 };
+const int kGridRadius[] = { 25, 50, 100, 150, 250, 400 };
+const double kGridTriggerTime[] = { 0.5, 0.75, 1.0, 1.5, 2.0, 3.0 };
+const int kGridClickTime[] = { 1, 2, 3 };
+
+// Refine search: proportion of the budget spent on the initial random sample, and the number of
+// best candidates perturbed in each subsequent round
+const double kRefineExploration = 0.5;
+const std::size_t kRefineParents = 8;
+const std::size_t kRefineRounds = 4;
+
+void print_usage()
+{
+    std::printf("Usage: PointyTune <session directory> [options]\n"
+                "\n"
+                "Searches for the deadzone, speed and dwell settings that point most accurately across a\n"
+                "user's recorded sessions (*.pty).\n"
+                "\n"
+                "Options:\n"
+                "  --search <grid|random|refine>  search strategy (default: grid)\n"
+                "  --samples <n>                  configurations to evaluate for random and refine (default: 2000)\n"
+                "  --threads <n>                  worker threads (default: all cores)\n"
+                "  --top <n>                      configurations to list (default: 10)\n"
+                "  --report <file>                write every evaluated configuration to a CSV file\n"
+                "  --screen <w>x<h>               simulated desktop size (default: 1920x1080)\n"
+                "  --seed <n>                     random seed (default: 1)\n"
+                "  --weight-efficiency <w>        (default: 1)\n"
+                "  --weight-overshoot <w>         (default: 1)\n"
+                "  --weight-false-clicks <w>      (default: 0.5)\n"
+                "  --weight-time <w>              per second between clicks (default: 0.05)\n");
+}
+
+bool parse_options(int argc, char* argv[], Options& options)
+{
+    std::vector<std::string> positional;
+    for (int i = 1; i < argc; ++i)
+    {
+        const std::string argument = argv[i];
+        const bool has_value = i + 1 < argc;
+
+        if (argument == "--search" && has_value)
+        {
+            const std::string search = argv[++i];
+            if (search == "grid")
+                options.search = Search::kGrid;
+            else if (search == "random")
+                options.search = Search::kRandom;
+            else if (search == "refine")
+                options.search = Search::kRefine;
+            else
+                return false;
+        }
+        else if (argument == "--samples" && has_value)
+        {
+            // Zero is also what a value that is not a number comes out as
+            const long samples = std::atol(argv[++i]);
+            if (samples <= 0)
+                return false;
+            options.samples = static_cast<std::size_t>(samples);
+        }
+        else if (argument == "--threads" && has_value)
+            options.threads = static_cast<unsigned int>(std::atoi(argv[++i]));
+        else if (argument == "--top" && has_value)
+            options.top = static_cast<std::size_t>(std::atol(argv[++i]));
+        else if (argument == "--report" && has_value)
+            options.report = argv[++i];
+        else if (argument == "--seed" && has_value)
+            options.seed = static_cast<unsigned int>(std::atoi(argv[++i]));
+        else if (argument == "--weight-efficiency" && has_value)
+            options.weights.efficiency = std::atof(argv[++i]);
+        else if (argument == "--weight-overshoot" && has_value)
+            options.weights.overshoot = std::atof(argv[++i]);
+        else if (argument == "--weight-false-clicks" && has_value)
+            options.weights.false_clicks = std::atof(argv[++i]);
+        else if (argument == "--weight-time" && has_value)
+            options.weights.target_time = std::atof(argv[++i]);
+        else if (argument == "--screen" && has_value)
+        {
+            if (std::sscanf(argv[++i], "%dx%d", &options.screen.width, &options.screen.height) != 2)
+                return false;
+        }
+        else if (argument.compare(0, 2, "--") == 0)
+            return false;
+        else
+            positional.push_back(argument);
+    }
+
+    if (positional.size() != 1)
+        return false;
+
+    options.input = positional[0];
+    if (options.threads == 0)
+        options.threads = std::max(1u, std::thread::hardware_concurrency());
+    return true;
+}
+
+Candidate make_candidate(const int& deadzone, const int& speed, const int& radius, const double& trigger_time, const int& click_time)
+{
+    Candidate candidate;
+    candidate.pointer.tolerance = deadzone;
+    candidate.pointer.speed = speed;
+    candidate.dwell.radius = radius;
+    candidate.dwell.trigger_time = trigger_time;
+    candidate.dwell.click_time = click_time;
+    return candidate;
+}
+
+std::vector<Candidate> grid_candidates()
+{
+    std::vector<Candidate> candidates;
+    for (int deadzone : kGridDeadzone)
+        for (int speed = kSpeedMin; speed <= kSpeedMax; ++speed)
+            for (int radius : kGridRadius)
+                for (double trigger_time : kGridTriggerTime)
+                    for (int click_time : kGridClickTime)
+                        candidates.push_back(make_candidate(deadzone, speed, radius, trigger_time, click_time));
+    return candidates;
+}
+
+std::vector<Candidate> random_candidates(const std::size_t& count, std::mt19937& generator)
+{
+    std::uniform_int_distribution<int> deadzone(kDeadzoneMin, kDeadzoneMax / 4);
+    std::uniform_int_distribution<int> speed(kSpeedMin, kSpeedMax);
+    std::uniform_int_distribution<int> radius(kRadiusMin, kRadiusMax / 2);
+    std::uniform_real_distribution<double> trigger_time(kTriggerTimeMin, kTriggerTimeMax / 2);
+    std::uniform_int_distribution<int> click_time(kClickTimeMin, kClickTimeMax / 2);
+
+    std::vector<Candidate> candidates;
+    for (std::size_t i = 0; i < count; ++i)
+        candidates.push_back(make_candidate(deadzone(generator), speed(generator), radius(generator), trigger_time(generator), click_time(generator)));
+    return candidates;
+}
+
+template<class T>
+T clamp(const T& value, const T& minimum, const T& maximum)
+{
+    return std::min(std::max(value, minimum), maximum);
+}
+
+Candidate perturb(const Candidate& parent, std::mt19937& generator)
+{
+    std::normal_distribution<double> step(0.0, 1.0);
+
+    Candidate child = parent;
+    child.pointer.tolerance = clamp(parent.pointer.tolerance + static_cast<int>(std::lround(step(generator) * 2.0)), kDeadzoneMin, kDeadzoneMax);
+    child.pointer.speed = clamp(parent.pointer.speed + static_cast<int>(std::lround(step(generator))), kSpeedMin, kSpeedMax);
+    child.dwell.radius = clamp(parent.dwell.radius + static_cast<int>(std::lround(step(generator) * 25.0)), kRadiusMin, kRadiusMax);
+    child.dwell.trigger_time = clamp(parent.dwell.trigger_time + step(generator) * 0.25, kTriggerTimeMin, kTriggerTimeMax);
+    child.dwell.click_time = clamp(parent.dwell.click_time + std::round(step(generator) * 0.5), static_cast<double>(kClickTimeMin), static_cast<double>(kClickTimeMax));
+    child.score = TrajectoryScore();
+    return child;
+}
+
+/**
+ * \brief Scores every candidate against every session in parallel, one task per candidate
+ */
+void evaluate(std::vector<Candidate>& candidates, const std::size_t& begin, const std::vector<std::unique_ptr<SessionReader>>& sessions, const Options& options, WorkStealingPool& pool)
+{
+    for (std::size_t i = begin; i < candidates.size(); ++i)
+    {
+        Candidate* candidate = &candidates[i];
+        pool.submit([candidate, &sessions, &options]()
+        {
+            for (const std::unique_ptr<SessionReader>& session : sessions)
+                candidate->score.add(simulate_session(*session, candidate->pointer, FilterSettings(), candidate->dwell, options.screen, OutputSettings()));
+            candidate->value = candidate->score.score(options.weights);
+        });
+    }
+    pool.wait();
+}
+
+void sort_candidates(std::vector<Candidate>& candidates)
+{
+    std::stable_sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.value > b.value; });
+}
+
+void print_candidate(const Candidate& candidate)
+{
+    std::printf("%8.4f %8.3f %9.3f %8.3f %9.2fs %9d %6d %7d %8.0fms %6.0fs\n", candidate.value, candidate.score.efficiency(),
+                candidate.score.overshoot(), candidate.score.false_click_rate(), candidate.score.target_time(), candidate.pointer.tolerance,
+                candidate.pointer.speed, candidate.dwell.radius, candidate.dwell.trigger_time * 1000.0, candidate.dwell.click_time);
+}
+
+void write_report(const std::string& path, const std::vector<Candidate>& candidates)
+{
+    std::ofstream stream(path.c_str());
+    stream << "score,efficiency,overshoot,false_click_rate,target_time,segments,deadzone,speed,radius,trigger_time_ms,click_time_s\n";
+    for (const Candidate& candidate : candidates)
+    {
+        stream << candidate.value << "," << candidate.score.efficiency() << "," << candidate.score.overshoot() << ","
+               << candidate.score.false_click_rate() << "," << candidate.score.target_time() << "," << candidate.score.segments << ","
+               << candidate.pointer.tolerance << "," << candidate.pointer.speed << "," << candidate.dwell.radius << ","
+               << candidate.dwell.trigger_time * 1000.0 << "," << candidate.dwell.click_time << "\n";
+    }
+}
+
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!parse_options(argc, argv, options))
+    {
+        print_usage();
+        return 1;
+    }
+
+    // Sessions are mapped once and shared read-only between every evaluation
+    std::vector<std::unique_ptr<SessionReader>> sessions;
+    std::uint64_t samples = 0;
+    for (const std::string& path : list_sessions(options.input))
+    {
+        std::unique_ptr<SessionReader> session(new SessionReader());
+        if (!session->open(path))
+        {
+            std::fprintf(stderr, "Skipping unreadable session %s\n", path.c_str());
+            continue;
+        }
+        samples += session->record_count();
+        sessions.push_back(std::move(session));
+    }
+    if (sessions.empty())
+    {
+        std::fprintf(stderr, "No sessions found in %s\n", options.input.c_str());
+        return 1;
+    }
+
+    std::mt19937 generator(options.seed);
+    WorkStealingPool pool(options.threads);
+    const auto start = std::chrono::steady_clock::now();
+
+    std::vector<Candidate> candidates;
+    switch (options.search)
+    {
+    case Search::kGrid:
+        candidates = grid_candidates();
+        evaluate(candidates, 0, sessions, options, pool);
+        break;
+
+    case Search::kRandom:
+        candidates = random_candidates(options.samples, generator);
+        evaluate(candidates, 0, sessions, options, pool);
+        break;
+
+    case Search::kRefine:
+    {
+        // Explore the space at random, then spend the remaining budget perturbing the best configurations
+        candidates = random_candidates(std::max<std::size_t>(static_cast<std::size_t>(options.samples * kRefineExploration), 1), generator);
+        evaluate(candidates, 0, sessions, options, pool);
+
+        const std::size_t per_round = (options.samples - candidates.size()) / kRefineRounds;
+        for (std::size_t round = 0; round < kRefineRounds && per_round > 0; ++round)
+        {
+            sort_candidates(candidates);
+            const std::size_t parents = std::min(kRefineParents, candidates.size());
+            const std::size_t begin = candidates.size();
+            for (std::size_t i = 0; i < per_round; ++i)
+                candidates.push_back(perturb(candidates[i % parents], generator));
+            evaluate(candidates, begin, sessions, options, pool);
+        }
+        break;
+    }
+    }
+
+    const double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    if (candidates.empty())
+    {
+        std::fprintf(stderr, "No configurations were evaluated\n");
+        return 1;
+    }
+    sort_candidates(candidates);
+
+    std::printf("%8s %8s %9s %8s %10s %9s %6s %7s %10s %7s\n", "score", "effic.", "overshoot", "false", "time", "deadzone", "speed", "radius", "trigger", "click");
+    for (std::size_t i = 0; i < std::min(options.top, candidates.size()); ++i)
+        print_candidate(candidates[i]);
+
+    const double evaluations = static_cast<double>(candidates.size()) * samples;
+    std::printf("\n%zu configurations x %zu sessions in %.3fs on %u threads (%.0f samples/s, %llu steals)\n", candidates.size(),
+                sessions.size(), elapsed, pool.thread_count(), elapsed > 0.0 ? evaluations / elapsed : 0.0,
+                static_cast<unsigned long long>(pool.steal_count()));
+
+    const Candidate& best = candidates.front();
+    std::printf("\nRecommended settings: deadzone %d, speed %d, trigger radius %dpx, trigger time %.0fms, click time %.0fs\n",
+                best.pointer.tolerance, best.pointer.speed, best.dwell.radius, best.dwell.trigger_time * 1000.0, best.dwell.click_time);
+
+    if (!options.report.empty())
+        write_report(options.report, candidates);
+    return 0;
+}
@@ -0,0 +1,119 @@
+#include "trajectory_score.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// Clicks preceded by less travel than this (pixels) are treated as unintended clicks while resting
+const double kMinimumTargetDistance = 50.0;
+
+double distance(const TrajectoryPoint& a, const TrajectoryPoint& b)
+{
+    return std::hypot(static_cast<double>(b.x - a.x), static_cast<double>(b.y - a.y));
+}
+
+}
+
+/**
+ * \brief Adds every click segment of a simulated session to the score
+ * \param result simulated session
+ */
+void TrajectoryScore::add(const SimulationResult& result)
+{
+    if (result.trajectory.empty())
+    {
+        return;
+    }
+
+    TrajectoryPoint start = result.trajectory.front();
+    std::size_t point = 0;
+
+    for (const TrajectoryPoint& click : result.clicks)
+    {
+        const double direct = distance(start, click);
+        const double direction_x = click.x - start.x;
+        const double direction_y = click.y - start.y;
+
+        // Walk the trajectory up to the click, measuring its length and how far it passed the target
+        double travelled = 0.0;
+        double overshoot = 0.0;
+        TrajectoryPoint previous = start;
+        for (; point < result.trajectory.size() && result.trajectory[point].timestamp <= click.timestamp; ++point)
+        {
+            const TrajectoryPoint& current = result.trajectory[point];
+            travelled += distance(previous, current);
+            if (direct > 0.0)
+            {
+                const double along = ((current.x - start.x) * direction_x + (current.y - start.y) * direction_y) / direct;
+                overshoot = std::max(overshoot, along - direct);
+            }
+            previous = current;
+        }
+
+        if (direct < kMinimumTargetDistance)
+        {
+            ++false_clicks;
+        }
+        else
+        {
+            ++segments;
+            efficiency_sum += travelled > 0.0 ? std::min(1.0, direct / travelled) : 0.0;
+            overshoot_sum += overshoot / direct;
+            time_sum += click.timestamp - start.timestamp;
+        }
+
+        start = click;
+    }
+}
+
+/**
+ * \brief Returns the average ratio of straight line distance to distance travelled (1 = perfectly direct)
+ */
+double TrajectoryScore::efficiency() const
+{
+    return segments > 0 ? efficiency_sum / segments : 0.0;
+}
+
+/**
+ * \brief Returns the average distance travelled past the target relative to the target distance
+ */
+double TrajectoryScore::overshoot() const
+{
+    return segments > 0 ? overshoot_sum / segments : 0.0;
+}
+
+/**
+ * \brief Returns the average time (seconds) from one click to the next
+ */
+double TrajectoryScore::target_time() const
+{
+    return segments > 0 ? time_sum / segments : 0.0;
+}
+
+/**
+ * \brief Returns the proportion of clicks that were not preceded by movement towards a target
+ */
+double TrajectoryScore::false_click_rate() const
+{
+    const std::size_t clicks = segments + false_clicks;
+    return clicks > 0 ? static_cast<double>(false_clicks) / clicks : 0.0;
+}
+
+/**
+ * \brief Returns the weighted overall score, higher is better
+ * \param weights relative importance of each metric
+ */
+double TrajectoryScore::score(const ScoreWeights& weights) const
+{
+    // A configuration that never reaches a target is worse than any that does
+    if (segments == 0)
+    {
+        return -1.0e9;
+    }
+
+    return weights.efficiency * efficiency()
+            - weights.overshoot * overshoot()
+            - weights.false_clicks * false_click_rate()
+            - weights.target_time * target_time();
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "session_simulation.h"
+
+/**
+ * \brief Relative importance of each metric in the overall score
+ */
+struct ScoreWeights
+{
+
+    double efficiency = 1.0;
+    double overshoot = 1.0;
+    double false_clicks = 0.5;
+
+    // Per second of average time between clicks
+    double target_time = 0.05;
+
+};
+
+/**
+ * \brief Pointing quality metrics accumulated over one or more simulated sessions
+ *
+ * The trajectory is split into segments that end at each dwell click, every click is treated as
+ * the target the user was moving towards.
+ */
+struct TrajectoryScore
+{
+
+    std::size_t segments = 0;
+    std::size_t false_clicks = 0;
+
+    // Sums over every segment, see the accessors for the averages
+    double efficiency_sum = 0.0;
+    double overshoot_sum = 0.0;
+    double time_sum = 0.0;
+
+    void add(const SimulationResult& result);
+
+    double efficiency() const;
+    double overshoot() const;
+    double target_time() const;
+    double false_click_rate() const;
+
+    double score(const ScoreWeights& weights) const;
+
+};
@@ -0,0 +1,146 @@
+#include "work_stealing_pool.h"
+
+WorkStealingPool::WorkStealingPool(unsigned int threads) : running_(true), pending_(0), queued_(0), next_queue_(0), steals_(0)
+{
+    if (threads == 0)
+    {
+        threads = 1;
+    }
+
+    for (unsigned int i = 0; i < threads; ++i)
+    {
+        workers_.push_back(std::unique_ptr<Worker>(new Worker()));
+    }
+    for (unsigned int i = 0; i < threads; ++i)
+    {
+        threads_.push_back(std::thread(&WorkStealingPool::run, this, i));
+    }
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    wait();
+
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+        running_ = false;
+    }
+    work_available_.notify_all();
+    for (std::thread& thread : threads_)
+    {
+        thread.join();
+    }
+}
+
+/**
+ * \brief Queues a task, tasks are distributed across the workers' queues in turn
+ * \param task task to run
+ */
+void WorkStealingPool::submit(std::function<void()> task)
+{
+    pending_.fetch_add(1);
+
+    Worker* worker = workers_[next_queue_.fetch_add(1) % workers_.size()].get();
+    {
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->tasks.push_back(std::move(task));
+        queued_.fetch_add(1);
+    }
+
+    // Taking the lock orders the new task against a worker about to sleep, so the wake up is never lost
+    {
+        std::lock_guard<std::mutex> lock(idle_mutex_);
+    }
+    work_available_.notify_one();
+}
+
+/**
+ * \brief Blocks until every submitted task has completed
+ */
+void WorkStealingPool::wait()
+{
+    std::unique_lock<std::mutex> lock(idle_mutex_);
+    all_done_.wait(lock, [this] { return pending_.load() == 0; });
+}
+
+/**
+ * \brief Returns the number of worker threads
+ */
+unsigned int WorkStealingPool::thread_count() const
+{
+    return static_cast<unsigned int>(threads_.size());
+}
+
+/**
+ * \brief Returns the number of tasks that were run by a worker other than the one they were queued on
+ */
+std::uint64_t WorkStealingPool::steal_count() const
+{
+    return steals_.load(std::memory_order_relaxed);
+}
+
+/**
+ * \brief Worker thread, runs tasks until the pool is destroyed
+ * \param index index of the worker
+ */
+void WorkStealingPool::run(const unsigned int& index)
+{
+    std::function<void()> task;
+    while (true)
+    {
+        if (take(index, task))
+        {
+            task();
+            task = nullptr;
+            if (pending_.fetch_sub(1) == 1)
+            {
+                std::lock_guard<std::mutex> lock(idle_mutex_);
+                all_done_.notify_all();
+            }
+            continue;
+        }
+
+        // Nothing to take anywhere, sleep until a task is submitted or the pool is destroyed
+        std::unique_lock<std::mutex> lock(idle_mutex_);
+        work_available_.wait(lock, [this] { return !running_ || queued_.load() > 0; });
+        if (!running_)
+        {
+            return;
+        }
+    }
+}
+
+/**
+ * \brief Takes the next task for a worker, from its own queue first and then from the others
+ * \param index index of the worker
+ * \param task receives the task
+ */
+bool WorkStealingPool::take(const unsigned int& index, std::function<void()>& task)
+{
+    {
+        Worker* own = workers_[index].get();
+        std::lock_guard<std::mutex> lock(own->mutex);
+        if (!own->tasks.empty())
+        {
+            task = std::move(own->tasks.back());
+            own->tasks.pop_back();
+            queued_.fetch_sub(1);
+            return true;
+        }
+    }
+
+    for (std::size_t offset = 1; offset < workers_.size(); ++offset)
+    {
+        Worker* victim = workers_[(index + offset) % workers_.size()].get();
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->tasks.empty())
+        {
+            task = std::move(victim->tasks.front());
+            victim->tasks.pop_front();
+            queued_.fetch_sub(1);
+            steals_.fetch_add(1, std::memory_order_relaxed);
+            return true;
+        }
+    }
+    return false;
+}
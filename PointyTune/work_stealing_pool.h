@@ -0,0 +1,63 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \brief Fixed set of worker threads with per-worker task queues
+ *
+ * Each worker takes tasks from the back of its own queue and, once that is empty, steals from the
+ * front of the other workers' queues so uneven task costs are balanced automatically. Workers with
+ * nothing to take sleep until a task is submitted.
+ */
+class WorkStealingPool
+{
+
+ public:
+
+    explicit WorkStealingPool(unsigned int threads);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    void submit(std::function<void()> task);
+    void wait();
+
+    unsigned int thread_count() const;
+    std::uint64_t steal_count() const;
+
+ private:
+
+    struct Worker
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers_;
+    std::vector<std::thread> threads_;
+
+    // Idle workers wait for work_available_, wait() for all_done_
+    std::mutex idle_mutex_;
+    std::condition_variable work_available_;
+    std::condition_variable all_done_;
+
+    std::atomic<bool> running_;
+
+    // Tasks submitted and not yet completed, and those still sitting in a queue
+    std::atomic<std::size_t> pending_;
+    std::atomic<std::size_t> queued_;
+    std::atomic<std::size_t> next_queue_;
+    std::atomic<std::uint64_t> steals_;
+
+    void run(const unsigned int& index);
+    bool take(const unsigned int& index, std::function<void()>& task);
+
+};
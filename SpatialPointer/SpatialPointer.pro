@@ -36,13 +36,71 @@ LIBS += -L"$$_PRO_FILE_PWD_/Phidgets/lib" -lphidget21
 SOURCES += main.cpp\
         spatial_pointer.cpp \
     phidget_spatial.cpp \
-    overlay.cpp
+    overlay.cpp \
+    pointer_motion.cpp \
+    pointer_pipeline.cpp \
+    latency_histogram.cpp \
+    simulated_spatial.cpp \
+    memory_mapped_file.cpp \
+    replay_spatial.cpp \
+    session_reader.cpp \
+    session_recorder.cpp \
+    dwell_detector.cpp \
+    orientation_filter.cpp \
+    absolute_pointer.cpp \
+    gyro_bias_estimator.cpp \
+    sample_block.cpp \
+    block_kernels.cpp \
+    filter_bank.cpp \
+    one_euro_filter.cpp \
+    tremor_estimator.cpp \
+    ballistics_curve.cpp \
+    curve_dialog.cpp \
+    curve_editor.cpp \
+    cursor_model.cpp \
+    qt_cursor_output.cpp \
+    uinput_cursor_output.cpp \
+    output_coalescer.cpp \
+    rate_kalman.cpp
 
 HEADERS  += \
     spatial_pointer.h \
-    vector3.h \
+    linear_algebra.h \
     phidget_spatial.h \
-    overlay.h
+    overlay.h \
+    absolute_pointer.h \
+    ballistics_curve.h \
+    block_kernels.h \
+    curve_dialog.h \
+    curve_editor.h \
+    cursor_model.h \
+    cursor_output.h \
+    dwell_detector.h \
+    filter_bank.h \
+    gyro_bias_estimator.h \
+    latency_histogram.h \
+    memory_mapped_file.h \
+    monotonic_clock.h \
+    one_euro_filter.h \
+    orientation_filter.h \
+    output_coalescer.h \
+    pointer_motion.h \
+    pointer_pipeline.h \
+    qt_cursor_output.h \
+    rate_kalman.h \
+    replay_spatial.h \
+    sample_block.h \
+    seq_lock.h \
+    session_format.h \
+    session_reader.h \
+    session_recorder.h \
+    simd.h \
+    simulated_spatial.h \
+    spatial_sample.h \
+    spatial_source.h \
+    spsc_ring_buffer.h \
+    tremor_estimator.h \
+    uinput_cursor_output.h
 
 FORMS    += spatial_pointer.ui \
     overlay.ui
@@ -0,0 +1,109 @@
+#include "absolute_pointer.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+const double kDegreesPerRadian = 180.0 / 3.14159265358979323846;
+
+}
+
+AbsolutePointer::AbsolutePointer()
+{
+    reset();
+}
+
+/**
+ * \brief Sets the parameters used for subsequent packets
+ * \param settings new parameters
+ */
+void AbsolutePointer::set_settings(const AbsoluteSettings& settings)
+{
+    settings_ = settings;
+}
+
+/**
+ * \brief Returns the parameters currently in use
+ */
+const AbsoluteSettings& AbsolutePointer::settings() const
+{
+    return settings_;
+}
+
+/**
+ * \brief Discards the reference, the next orientation is taken as looking at the centre of the desktop
+ */
+void AbsolutePointer::reset()
+{
+    reference_ = Quatd();
+    has_reference_ = false;
+    last_timestamp_ = 0.0;
+    x_ = 0;
+    y_ = 0;
+}
+
+/**
+ * \brief Maps an orientation onto the desktop
+ * \param orientation fused orientation of the sensor
+ * \param sample packet the orientation was fused from
+ * \param invert whether to invert both axes, the same as in relative mode
+ */
+void AbsolutePointer::update(const Quatd& orientation, const SpatialSample& sample, const bool& invert)
+{
+    const double dt = sample.timestamp - last_timestamp_;
+    last_timestamp_ = sample.timestamp;
+
+    if (!has_reference_)
+    {
+        reference_ = orientation;
+        has_reference_ = true;
+    }
+
+    const DesktopGeometry& desktop = settings_.desktop;
+    const double centre_x = desktop.x + desktop.width * 0.5;
+    const double centre_y = desktop.y + desktop.height * 0.5;
+    const double pixels_per_degree = desktop.width / std::max(settings_.range, 1.0);
+
+    // Rotation away from the reference, expressed in the sensor frame at the reference
+    const Quatd rotation = reference_.conjugate() * orientation;
+    const double sign = invert ? -1.0 : 1.0;
+    const double offset_x = sign * rotation.yaw() * kDegreesPerRadian * pixels_per_degree;
+    const double offset_y = sign * rotation.roll() * kDegreesPerRadian * pixels_per_degree;
+
+    x_ = static_cast<int>(std::lround(std::min(std::max(centre_x + offset_x, static_cast<double>(desktop.x)), desktop.x + desktop.width - 1.0)));
+    y_ = static_cast<int>(std::lround(std::min(std::max(centre_y + offset_y, static_cast<double>(desktop.y)), desktop.y + desktop.height - 1.0)));
+
+    // While the user rests near the centre, ease the reference towards the current orientation so
+    // that drift is corrected where the user expects the cursor to be
+    const bool resting = std::abs(sample.angular_rate.x) < kRestingRate && std::abs(sample.angular_rate.z) < kRestingRate;
+    const bool near_centre = std::hypot(offset_x, offset_y) <= settings_.recenter_radius * desktop.width;
+    if (settings_.recenter && resting && near_centre && dt > 0.0 && dt <= kMaxSampleInterval && settings_.recenter_time > 0.0)
+    {
+        reference_ = nlerp(reference_, orientation, std::min(dt / settings_.recenter_time, 1.0));
+    }
+}
+
+/**
+ * \brief Returns whether a reference has been established and x() and y() are valid
+ */
+bool AbsolutePointer::has_position() const
+{
+    return has_reference_;
+}
+
+/**
+ * \brief Returns the horizontal position on the desktop (pixels)
+ */
+int AbsolutePointer::x() const
+{
+    return x_;
+}
+
+/**
+ * \brief Returns the vertical position on the desktop (pixels)
+ */
+int AbsolutePointer::y() const
+{
+    return y_;
+}
@@ -0,0 +1,89 @@
+#pragma once
+#include "linear_algebra.h"
+#include "spatial_sample.h"
+
+/**
+ * \brief Bounding rectangle of every monitor (pixels, virtual desktop coordinates)
+ */
+struct DesktopGeometry
+{
+
+    int x = 0;
+    int y = 0;
+    int width = 1920;
+    int height = 1080;
+
+};
+
+/**
+ * \brief User adjustable parameters of absolute pointing
+ */
+struct AbsoluteSettings
+{
+
+    bool enabled = false;
+
+    // Head rotation (degrees) that spans the full width of the desktop, the vertical range follows
+    // from the desktop's aspect ratio
+    double range = 60.0;
+
+    // Slowly realigns the centre of the desktop with the head while the user rests near it, absorbing
+    // heading drift and posture changes
+    bool recenter = true;
+
+    // Distance from the centre of the desktop within which recentering applies (fraction of the
+    // desktop width)
+    double recenter_radius = 0.1;
+
+    // Time constant of the recentering (seconds)
+    double recenter_time = 3.0;
+
+    DesktopGeometry desktop;
+
+};
+
+/**
+ * \brief Maps the fused orientation directly onto the virtual desktop
+ *
+ * The orientation when pointing begins is taken as looking at the centre of the desktop. The head's
+ * rotation away from that reference, about the same sensor axes that drive relative movement
+ * (z horizontally, x vertically), is scaled so that the configured range spans the desktop.
+ */
+class AbsolutePointer
+{
+
+ public:
+
+    AbsolutePointer();
+
+    void set_settings(const AbsoluteSettings& settings);
+    const AbsoluteSettings& settings() const;
+
+    void reset();
+
+    void update(const Quatd& orientation, const SpatialSample& sample, const bool& invert);
+
+    bool has_position() const;
+    int x() const;
+    int y() const;
+
+ private:
+
+    // Head movement slower than this (degrees per second) counts as resting for recentering
+    const double kRestingRate = 10.0;
+
+    // Gaps between packets longer than this (seconds) are treated as a restart of the stream
+    const double kMaxSampleInterval = 0.25;
+
+    AbsoluteSettings settings_;
+
+    // Orientation that maps onto the centre of the desktop
+    Quatd reference_;
+    bool has_reference_;
+
+    double last_timestamp_;
+
+    int x_;
+    int y_;
+
+};
@@ -0,0 +1,264 @@
+#include "ballistics_curve.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+
+namespace
+{
+
+/**
+ * \brief Returns whether two sets of parameters describe the same curve
+ */
+bool same_curve(const BallisticsSettings& a, const BallisticsSettings& b)
+{
+    return a.point_count == b.point_count && a.shape == b.shape && std::equal(a.speeds, a.speeds + BallisticsSettings::kMaxPoints, b.speeds)
+            && std::equal(a.gains, a.gains + BallisticsSettings::kMaxPoints, b.gains);
+}
+
+}
+
+/**
+ * \brief Reads control points written as speed:gain pairs separated by commas, e.g. "20:0.5,120:2"
+ * \param text control points, an empty string gives a linear pointer
+ * \param settings receives the control points, its shape is left unchanged
+ * \return whether the text held no more than BallisticsSettings::kMaxPoints valid points
+ */
+bool parse_curve(const std::string& text, BallisticsSettings& settings)
+{
+    BallisticsSettings parsed = settings;
+    parsed.point_count = 0;
+    std::fill(parsed.speeds, parsed.speeds + BallisticsSettings::kMaxPoints, 0.0f);
+    std::fill(parsed.gains, parsed.gains + BallisticsSettings::kMaxPoints, 0.0f);
+
+    std::istringstream stream(text);
+    std::string point;
+    while (std::getline(stream, point, ','))
+    {
+        if (point.find_first_not_of(" \t") == std::string::npos)
+        {
+            continue;
+        }
+
+        float speed = 0.0f;
+        float gain = 0.0f;
+        char separator = 0;
+        std::istringstream values(point);
+        if (!(values >> speed >> separator >> gain) || separator != ':' || !(speed >= 0.0f) || !(gain >= 0.0f))
+        {
+            return false;
+        }
+
+        if (parsed.point_count == BallisticsSettings::kMaxPoints)
+        {
+            return false;
+        }
+        parsed.speeds[parsed.point_count] = speed;
+        parsed.gains[parsed.point_count] = gain;
+        ++parsed.point_count;
+    }
+
+    settings = parsed;
+    return true;
+}
+
+/**
+ * \brief Writes control points in the form read by parse_curve
+ * \param settings curve to write
+ */
+std::string format_curve(const BallisticsSettings& settings)
+{
+    std::string text;
+    for (int i = 0; i < settings.point_count; ++i)
+    {
+        char point[64];
+        std::snprintf(point, sizeof(point), "%s%g:%g", i > 0 ? "," : "", settings.speeds[i], settings.gains[i]);
+        text += point;
+    }
+    return text;
+}
+
+BallisticsCurve::BallisticsCurve()
+{
+    compile();
+}
+
+/**
+ * \brief Sets the curve used for subsequent packets, the table is only recompiled when the curve changes
+ * \param settings new parameters
+ */
+void BallisticsCurve::set_settings(const BallisticsSettings& settings)
+{
+    if (same_curve(settings, settings_))
+    {
+        return;
+    }
+
+    settings_ = settings;
+    compile();
+}
+
+/**
+ * \brief Returns the parameters currently in use
+ */
+const BallisticsSettings& BallisticsCurve::settings() const
+{
+    return settings_;
+}
+
+/**
+ * \brief Returns whether the curve has any control points, without them the gain is one at every speed
+ */
+bool BallisticsCurve::enabled() const
+{
+    return point_count_ > 0;
+}
+
+/**
+ * \brief Looks up the gain at an angular speed in the compiled table
+ * \param speed angular speed (degrees per second)
+ */
+float BallisticsCurve::gain(const float& speed) const
+{
+    const float position = speed * scale_;
+    if (!(position < kTableSize))
+    {
+        return table_[kTableSize];
+    }
+
+    const int index = static_cast<int>(position);
+    const float fraction = position - index;
+    return table_[index] + fraction * (table_[index + 1] - table_[index]);
+}
+
+/**
+ * \brief Looks up the gain at a number of angular speeds
+ * \param speeds angular speeds (degrees per second)
+ * \param count number of speeds
+ * \param out receives the gains, may be the same array as speeds
+ */
+void BallisticsCurve::gains(const float* speeds, const std::size_t& count, float* out) const
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        out[i] = gain(speeds[i]);
+    }
+}
+
+/**
+ * \brief Evaluates the curve itself rather than its table, e.g. to draw it
+ * \param speed angular speed (degrees per second)
+ */
+float BallisticsCurve::evaluate(const float& speed) const
+{
+    if (point_count_ == 0)
+    {
+        return 1.0f;
+    }
+    if (speed <= speeds_[0])
+    {
+        return gains_[0];
+    }
+    if (speed >= speeds_[point_count_ - 1])
+    {
+        return gains_[point_count_ - 1];
+    }
+
+    int k = 0;
+    while (speed >= speeds_[k + 1])
+    {
+        ++k;
+    }
+
+    const float width = speeds_[k + 1] - speeds_[k];
+    const float t = (speed - speeds_[k]) / width;
+    if (settings_.shape == CurveShape::kLinear)
+    {
+        return gains_[k] + t * (gains_[k + 1] - gains_[k]);
+    }
+
+    // A cubic Hermite segment, the same curve as a Bezier segment with handles a third of the way along the tangents
+    const float t2 = t * t;
+    const float t3 = t2 * t;
+    return (2.0f * t3 - 3.0f * t2 + 1.0f) * gains_[k] + (t3 - 2.0f * t2 + t) * width * tangents_[k]
+            + (-2.0f * t3 + 3.0f * t2) * gains_[k + 1] + (t3 - t2) * width * tangents_[k + 1];
+}
+
+/**
+ * \brief Sorts the control points, computes the tangents of the smooth shape and fills the table
+ */
+void BallisticsCurve::compile()
+{
+    // Sort the points by speed, of points sharing a speed the last one wins
+    point_count_ = 0;
+    for (int i = 0; i < std::min(std::max(settings_.point_count, 0), static_cast<int>(BallisticsSettings::kMaxPoints)); ++i)
+    {
+        const float speed = settings_.speeds[i];
+        const float gain = settings_.gains[i];
+        if (!(speed >= 0.0f) || !std::isfinite(speed) || !(gain >= 0.0f) || !std::isfinite(gain))
+        {
+            continue;
+        }
+
+        int k = point_count_;
+        while (k > 0 && speeds_[k - 1] > speed)
+        {
+            --k;
+        }
+        if (k > 0 && speeds_[k - 1] == speed)
+        {
+            gains_[k - 1] = gain;
+            continue;
+        }
+
+        std::copy_backward(speeds_ + k, speeds_ + point_count_, speeds_ + point_count_ + 1);
+        std::copy_backward(gains_ + k, gains_ + point_count_, gains_ + point_count_ + 1);
+        speeds_[k] = speed;
+        gains_[k] = gain;
+        ++point_count_;
+    }
+
+    // Monotone tangents (Fritsch-Carlson), each starts as the average of the neighbouring slopes
+    // and is flattened wherever it would make the segment overshoot
+    for (int k = 0; k < point_count_; ++k)
+    {
+        const float before = k > 0 ? (gains_[k] - gains_[k - 1]) / (speeds_[k] - speeds_[k - 1]) : 0.0f;
+        const float after = k + 1 < point_count_ ? (gains_[k + 1] - gains_[k]) / (speeds_[k + 1] - speeds_[k]) : 0.0f;
+        if (k == 0 || k + 1 == point_count_)
+        {
+            tangents_[k] = k == 0 ? after : before;
+        }
+        else
+        {
+            tangents_[k] = before * after > 0.0f ? (before + after) / 2.0f : 0.0f;
+        }
+    }
+    for (int k = 0; k + 1 < point_count_; ++k)
+    {
+        const float slope = (gains_[k + 1] - gains_[k]) / (speeds_[k + 1] - speeds_[k]);
+        if (slope == 0.0f)
+        {
+            tangents_[k] = 0.0f;
+            tangents_[k + 1] = 0.0f;
+            continue;
+        }
+
+        const float alpha = tangents_[k] / slope;
+        const float beta = tangents_[k + 1] / slope;
+        const float length = alpha * alpha + beta * beta;
+        if (length > 9.0f)
+        {
+            const float tau = 3.0f / std::sqrt(length);
+            tangents_[k] = tau * alpha * slope;
+            tangents_[k + 1] = tau * beta * slope;
+        }
+    }
+
+    const float last_speed = point_count_ > 0 ? speeds_[point_count_ - 1] : 0.0f;
+    scale_ = last_speed > 0.0f ? kTableSize / last_speed : 0.0f;
+    for (int i = 0; i < kTableSize; ++i)
+    {
+        table_[i] = scale_ > 0.0f ? evaluate(i / scale_) : evaluate(last_speed);
+    }
+    table_[kTableSize] = evaluate(last_speed);
+}
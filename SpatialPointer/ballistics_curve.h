@@ -0,0 +1,85 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * \brief How the acceleration curve passes between its control points
+ */
+enum class CurveShape
+{
+    kLinear,
+    kSmooth
+};
+
+/**
+ * \brief User adjustable acceleration curve, the gain applied to the pointer speed at each angular speed
+ */
+struct BallisticsSettings
+{
+
+    static const int kMaxPoints = 8;
+
+    // Control points, angular speed (degrees per second) and the gain at that speed. Without any
+    // points the gain is one at every speed and the pointer moves linearly
+    int point_count = 0;
+    float speeds[kMaxPoints] = {};
+    float gains[kMaxPoints] = {};
+
+    CurveShape shape = CurveShape::kSmooth;
+
+};
+
+bool parse_curve(const std::string& text, BallisticsSettings& settings);
+std::string format_curve(const BallisticsSettings& settings);
+
+/**
+ * \brief Pointer ballistics, maps the head's angular speed to a multiplier of the pointer speed
+ *
+ * Slow movement can be given a low gain for precise targeting and fast movement a high one for
+ * crossing the desktop. The curve passes through its control points either in straight lines or
+ * as cubic Bezier segments whose handles follow monotone tangents (Fritsch-Carlson), so a smooth
+ * curve never overshoots between two points. The gain is constant before the first point and
+ * after the last one.
+ *
+ * The curve is compiled into a dense table whenever the settings change, so the pointer only pays
+ * for a table lookup and a linear interpolation per packet.
+ */
+class BallisticsCurve
+{
+
+ public:
+
+    BallisticsCurve();
+
+    void set_settings(const BallisticsSettings& settings);
+    const BallisticsSettings& settings() const;
+
+    bool enabled() const;
+
+    float gain(const float& speed) const;
+    void gains(const float* speeds, const std::size_t& count, float* out) const;
+
+    float evaluate(const float& speed) const;
+
+ private:
+
+    // Intervals of the table between zero and the speed of the last control point
+    static const int kTableSize = 256;
+
+    BallisticsSettings settings_;
+
+    // Control points sorted by speed without duplicate speeds, and the curve's tangent at each
+    int point_count_;
+    float speeds_[BallisticsSettings::kMaxPoints];
+    float gains_[BallisticsSettings::kMaxPoints];
+    float tangents_[BallisticsSettings::kMaxPoints];
+
+    // Gain at each step of the table, the last entry holds the gain beyond the last control point
+    float table_[kTableSize + 1];
+
+    // Table steps per degree per second
+    float scale_;
+
+    void compile();
+
+};
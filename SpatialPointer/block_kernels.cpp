@@ -0,0 +1,179 @@
+#include "block_kernels.h"
+#include "simd.h"
+#include <cmath>
+
+namespace
+{
+
+#ifdef POINTY_AVX
+
+/**
+ * \brief Sum of the four lanes of a register
+ */
+inline double horizontal_sum(const __m256d& value)
+{
+    const __m128d pair = _mm_add_pd(_mm256_castpd256_pd128(value), _mm256_extractf128_pd(value, 1));
+    return _mm_cvtsd_f64(_mm_add_sd(pair, _mm_unpackhi_pd(pair, pair)));
+}
+
+#elif defined(POINTY_SSE2)
+
+/**
+ * \brief Sum of the two lanes of a register
+ */
+inline double horizontal_sum(const __m128d& value)
+{
+    return _mm_cvtsd_f64(_mm_add_sd(value, _mm_unpackhi_pd(value, value)));
+}
+
+#endif
+
+}
+
+void block_add(float* values, const std::size_t& count, const float& offset)
+{
+    std::size_t i = 0;
+
+#if defined(POINTY_AVX)
+    const __m256 o = _mm256_set1_ps(offset);
+    for (; i + 8 <= count; i += 8)
+        _mm256_storeu_ps(values + i, _mm256_add_ps(_mm256_loadu_ps(values + i), o));
+#elif defined(POINTY_SSE2)
+    const __m128 o = _mm_set1_ps(offset);
+    for (; i + 4 <= count; i += 4)
+        _mm_storeu_ps(values + i, _mm_add_ps(_mm_loadu_ps(values + i), o));
+#endif
+
+    for (; i < count; ++i)
+        values[i] += offset;
+}
+
+void block_length(const float* x, const float* y, const float* z, const std::size_t& count, float* lengths)
+{
+    std::size_t i = 0;
+
+#if defined(POINTY_AVX)
+    for (; i + 8 <= count; i += 8)
+    {
+        const __m256 vx = _mm256_loadu_ps(x + i);
+        const __m256 vy = _mm256_loadu_ps(y + i);
+        const __m256 vz = _mm256_loadu_ps(z + i);
+        const __m256 square = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)), _mm256_mul_ps(vz, vz));
+        _mm256_storeu_ps(lengths + i, _mm256_sqrt_ps(square));
+    }
+#elif defined(POINTY_SSE2)
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 vx = _mm_loadu_ps(x + i);
+        const __m128 vy = _mm_loadu_ps(y + i);
+        const __m128 vz = _mm_loadu_ps(z + i);
+        const __m128 square = _mm_add_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)), _mm_mul_ps(vz, vz));
+        _mm_storeu_ps(lengths + i, _mm_sqrt_ps(square));
+    }
+#endif
+
+    for (; i < count; ++i)
+        lengths[i] = std::sqrt(x[i] * x[i] + y[i] * y[i] + z[i] * z[i]);
+}
+
+void block_moments(const float* values, const std::size_t& count, double& sum, double& square_sum)
+{
+    std::size_t i = 0;
+
+#if defined(POINTY_AVX)
+    __m256d s = _mm256_setzero_pd();
+    __m256d q = _mm256_setzero_pd();
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256d v = _mm256_cvtps_pd(_mm_loadu_ps(values + i));
+        s = _mm256_add_pd(s, v);
+        q = _mm256_add_pd(q, _mm256_mul_pd(v, v));
+    }
+    sum += horizontal_sum(s);
+    square_sum += horizontal_sum(q);
+#elif defined(POINTY_SSE2)
+    __m128d s = _mm_setzero_pd();
+    __m128d q = _mm_setzero_pd();
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m128 v = _mm_loadu_ps(values + i);
+        const __m128d low = _mm_cvtps_pd(v);
+        const __m128d high = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+        s = _mm_add_pd(s, _mm_add_pd(low, high));
+        q = _mm_add_pd(q, _mm_add_pd(_mm_mul_pd(low, low), _mm_mul_pd(high, high)));
+    }
+    sum += horizontal_sum(s);
+    square_sum += horizontal_sum(q);
+#endif
+
+    for (; i < count; ++i)
+    {
+        const double v = values[i];
+        sum += v;
+        square_sum += v * v;
+    }
+}
+
+double block_dot(const float* a, const float* b, const std::size_t& count)
+{
+    double sum = 0.0;
+    std::size_t i = 0;
+
+#if defined(POINTY_AVX)
+    __m256d s = _mm256_setzero_pd();
+    for (; i + 4 <= count; i += 4)
+        s = _mm256_add_pd(s, _mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(a + i)), _mm256_cvtps_pd(_mm_loadu_ps(b + i))));
+    sum = horizontal_sum(s);
+#elif defined(POINTY_SSE2)
+    __m128d s = _mm_setzero_pd();
+    for (; i + 2 <= count; i += 2)
+    {
+        const __m128d va = _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(a + i))));
+        const __m128d vb = _mm_cvtps_pd(_mm_castpd_ps(_mm_load_sd(reinterpret_cast<const double*>(b + i))));
+        s = _mm_add_pd(s, _mm_mul_pd(va, vb));
+    }
+    sum = horizontal_sum(s);
+#endif
+
+    for (; i < count; ++i)
+        sum += static_cast<double>(a[i]) * b[i];
+    return sum;
+}
+
+void block_intervals(const double* timestamps, const std::size_t& count, const double& previous, const double& max_interval, float* intervals)
+{
+    if (count == 0)
+        return;
+
+    // The first interval depends on the previous block, NaN compares false so a missing one gives zero
+    const double first = timestamps[0] - previous;
+    intervals[0] = first > 0.0 && first <= max_interval ? static_cast<float>(first) : 0.0f;
+
+    std::size_t i = 1;
+
+#if defined(POINTY_AVX)
+    const __m256d zero = _mm256_setzero_pd();
+    const __m256d limit = _mm256_set1_pd(max_interval);
+    for (; i + 4 <= count; i += 4)
+    {
+        const __m256d dt = _mm256_sub_pd(_mm256_loadu_pd(timestamps + i), _mm256_loadu_pd(timestamps + i - 1));
+        const __m256d valid = _mm256_and_pd(_mm256_cmp_pd(dt, zero, _CMP_GT_OQ), _mm256_cmp_pd(dt, limit, _CMP_LE_OQ));
+        _mm_storeu_ps(intervals + i, _mm256_cvtpd_ps(_mm256_and_pd(dt, valid)));
+    }
+#elif defined(POINTY_SSE2)
+    const __m128d zero = _mm_setzero_pd();
+    const __m128d limit = _mm_set1_pd(max_interval);
+    for (; i + 2 <= count; i += 2)
+    {
+        const __m128d dt = _mm_sub_pd(_mm_loadu_pd(timestamps + i), _mm_loadu_pd(timestamps + i - 1));
+        const __m128d valid = _mm_and_pd(_mm_cmpgt_pd(dt, zero), _mm_cmple_pd(dt, limit));
+        _mm_storel_pi(reinterpret_cast<__m64*>(intervals + i), _mm_cvtpd_ps(_mm_and_pd(dt, valid)));
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        const double dt = timestamps[i] - timestamps[i - 1];
+        intervals[i] = dt > 0.0 && dt <= max_interval ? static_cast<float>(dt) : 0.0f;
+    }
+}
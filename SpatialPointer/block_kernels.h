@@ -0,0 +1,26 @@
+#pragma once
+#include <cstddef>
+
+/**
+ * \brief Kernels over single channels of a SampleBlock
+ *
+ * Each kernel processes a register of values at a time with AVX or SSE2 when the compiler targets
+ * them, and finishes the tail (or the whole array without SIMD) one value at a time. Sums are
+ * accumulated in double precision whatever the precision of the channel.
+ */
+
+// Adds an offset to every value, e.g. subtracting a gyroscope bias
+void block_add(float* values, const std::size_t& count, const float& offset);
+
+// Writes the length of each (x, y, z) triple
+void block_length(const float* x, const float* y, const float* z, const std::size_t& count, float* lengths);
+
+// Sum and sum of squares of the values, added to sum and square_sum
+void block_moments(const float* values, const std::size_t& count, double& sum, double& square_sum);
+
+// Sum of the products of corresponding values
+double block_dot(const float* a, const float* b, const std::size_t& count);
+
+// Time between each timestamp and the one before it, previous precedes the first. Intervals that
+// are not positive or exceed max_interval (a restart of the stream) are written as zero.
+void block_intervals(const double* timestamps, const std::size_t& count, const double& previous, const double& max_interval, float* intervals);
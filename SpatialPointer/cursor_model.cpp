@@ -0,0 +1,141 @@
+#include "cursor_model.h"
+#include <algorithm>
+#include <cstdint>
+
+namespace
+{
+
+/**
+ * \brief Returns whether two layouts place the same monitors in the same places
+ */
+bool same_layout(const DesktopLayout& a, const DesktopLayout& b)
+{
+    if (a.screen_count != b.screen_count)
+    {
+        return false;
+    }
+
+    for (int i = 0; i < a.screen_count; ++i)
+    {
+        const ScreenRect& first = a.screens[i];
+        const ScreenRect& second = b.screens[i];
+        if (first.x != second.x || first.y != second.y || first.width != second.width || first.height != second.height)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+CursorModel::CursorModel() : x_(0), y_(0)
+{
+}
+
+/**
+ * \brief Sets the arrangement of the monitors, the tracked position is clamped onto them
+ * \param layout new arrangement, without any monitors the position is not clamped
+ */
+void CursorModel::set_layout(const DesktopLayout& layout)
+{
+    if (same_layout(layout, layout_))
+    {
+        return;
+    }
+
+    layout_ = layout;
+    clamp(x_, y_);
+}
+
+/**
+ * \brief Returns the arrangement of the monitors
+ */
+const DesktopLayout& CursorModel::layout() const
+{
+    return layout_;
+}
+
+/**
+ * \brief Replaces the tracked position with the real cursor's
+ * \param x horizontal position (pixels)
+ * \param y vertical position (pixels)
+ */
+void CursorModel::sync(const int& x, const int& y)
+{
+    x_ = x;
+    y_ = y;
+}
+
+/**
+ * \brief Returns whether the real cursor is where the model expects it, i.e. nothing else has moved it
+ * \param x horizontal position of the real cursor (pixels)
+ * \param y vertical position of the real cursor (pixels)
+ */
+bool CursorModel::matches(const int& x, const int& y) const
+{
+    return x == x_ && y == y_;
+}
+
+/**
+ * \brief Moves the tracked position, keeping it on the desktop
+ * \param dx horizontal displacement (pixels)
+ * \param dy vertical displacement (pixels)
+ */
+void CursorModel::move(const int& dx, const int& dy)
+{
+    x_ += dx;
+    y_ += dy;
+    clamp(x_, y_);
+}
+
+/**
+ * \brief Returns the horizontal position (pixels)
+ */
+int CursorModel::x() const
+{
+    return x_;
+}
+
+/**
+ * \brief Returns the vertical position (pixels)
+ */
+int CursorModel::y() const
+{
+    return y_;
+}
+
+/**
+ * \brief Moves a position onto the nearest monitor
+ * \param x horizontal position (pixels), clamped in place
+ * \param y vertical position (pixels), clamped in place
+ */
+void CursorModel::clamp(int& x, int& y) const
+{
+    int nearest_x = x;
+    int nearest_y = y;
+    std::int64_t nearest_distance = -1;
+    for (int i = 0; i < std::min(layout_.screen_count, static_cast<int>(DesktopLayout::kMaxScreens)); ++i)
+    {
+        const ScreenRect& screen = layout_.screens[i];
+        if (screen.width <= 0 || screen.height <= 0)
+        {
+            continue;
+        }
+
+        const int clamped_x = std::min(std::max(x, screen.x), screen.x + screen.width - 1);
+        const int clamped_y = std::min(std::max(y, screen.y), screen.y + screen.height - 1);
+        const std::int64_t offset_x = clamped_x - x;
+        const std::int64_t offset_y = clamped_y - y;
+        const std::int64_t distance = offset_x * offset_x + offset_y * offset_y;
+        if (nearest_distance < 0 || distance < nearest_distance)
+        {
+            nearest_x = clamped_x;
+            nearest_y = clamped_y;
+            nearest_distance = distance;
+        }
+    }
+
+    x = nearest_x;
+    y = nearest_y;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+/**
+ * \brief Rectangle of a single monitor (pixels, virtual desktop coordinates)
+ */
+struct ScreenRect
+{
+
+    int x = 0;
+    int y = 0;
+    int width = 0;
+    int height = 0;
+
+};
+
+/**
+ * \brief Arrangement of the monitors making up the virtual desktop
+ */
+struct DesktopLayout
+{
+
+    static const int kMaxScreens = 8;
+
+    int screen_count = 0;
+    ScreenRect screens[kMaxScreens];
+
+};
+
+/**
+ * \brief Locally tracked cursor position, so moving the cursor never has to ask the display server where it is
+ *
+ * Moves are applied to the tracked position and clamped onto the monitors the way the display
+ * server clamps the real cursor: a position on any monitor is kept, one in a gap between monitors
+ * or off the desktop is moved to the nearest point of the nearest monitor. The position is only
+ * replaced by the real cursor's when the cursor has been moved by something else, e.g. the mouse.
+ */
+class CursorModel
+{
+
+ public:
+
+    CursorModel();
+
+    void set_layout(const DesktopLayout& layout);
+    const DesktopLayout& layout() const;
+
+    void sync(const int& x, const int& y);
+    bool matches(const int& x, const int& y) const;
+
+    void move(const int& dx, const int& dy);
+
+    int x() const;
+    int y() const;
+
+ private:
+
+    DesktopLayout layout_;
+
+    int x_;
+    int y_;
+
+    void clamp(int& x, int& y) const;
+
+};
@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+
+/**
+ * \brief Destination of the cursor movement and clicks produced by Pointy
+ *
+ * The pipeline moves the cursor from its own thread while the overlay clicks from the GUI thread,
+ * so an output must accept moves and clicks from different threads.
+ */
+class CursorOutput
+{
+
+ public:
+
+    virtual ~CursorOutput() {}
+
+    /**
+     * \brief Prepares the output, returns false when it is unavailable
+     */
+    virtual bool open() = 0;
+
+    /**
+     * \brief Releases the output, nothing is moved or clicked once this returns
+     */
+    virtual void close() = 0;
+
+    /**
+     * \brief Returns whether the output only moves the cursor relative to wherever it is, in which
+     * case the cursor's position cannot be read back from the output
+     */
+    virtual bool relative() const = 0;
+
+    /**
+     * \brief Moves the cursor, a relative output uses the displacement and an absolute one the position
+     * \param dx horizontal displacement (pixels)
+     * \param dy vertical displacement (pixels)
+     * \param x horizontal position the cursor is expected to reach (pixels across the virtual desktop)
+     * \param y vertical position the cursor is expected to reach (pixels across the virtual desktop)
+     */
+    virtual void move(const int& dx, const int& dy, const int& x, const int& y) = 0;
+
+    /**
+     * \brief Returns whether every move made so far has reached the cursor, an output may place
+     * the cursor some time after move returns
+     * \param time receives when the latest move reached the cursor (nanoseconds of the monotonic clock)
+     */
+    virtual bool landed(std::int64_t& time) const = 0;
+
+    /**
+     * \brief Presses and releases the left button wherever the cursor is
+     */
+    virtual void click() = 0;
+
+};
@@ -0,0 +1,79 @@
+#include "curve_dialog.h"
+#include "curve_editor.h"
+#include <QComboBox>
+#include <QDialogButtonBox>
+#include <QHBoxLayout>
+#include <QLabel>
+#include <QPushButton>
+#include <QVBoxLayout>
+
+/**
+ * @brief Initialize
+ * @param settings curve to edit
+ * @param parent parent widget
+ */
+CurveDialog::CurveDialog(const BallisticsSettings& settings, QWidget *parent) : QDialog(parent)
+{
+    setWindowTitle("Acceleration curve");
+
+    editor_ = new CurveEditor(this);
+    editor_->set_settings(settings);
+
+    QLabel* lbl_hint = new QLabel("Click to add a point, drag to move it and right-click to remove it. Without points the speed is constant.", this);
+    lbl_hint->setWordWrap(true);
+
+    // Items follow the order of CurveShape
+    cmb_shape_ = new QComboBox(this);
+    cmb_shape_->addItem("Linear");
+    cmb_shape_->addItem("Smooth");
+    cmb_shape_->setCurrentIndex(static_cast<int>(settings.shape));
+    connect(cmb_shape_, SIGNAL(currentIndexChanged(int)), this, SLOT(slot_shape_changed(int)));
+
+    QPushButton* btn_clear = new QPushButton("Clear", this);
+    connect(btn_clear, SIGNAL(clicked()), this, SLOT(slot_clear()));
+
+    QDialogButtonBox* buttons = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel, this);
+    connect(buttons, SIGNAL(accepted()), this, SLOT(accept()));
+    connect(buttons, SIGNAL(rejected()), this, SLOT(reject()));
+
+    QHBoxLayout* controls = new QHBoxLayout();
+    controls->addWidget(new QLabel("Shape:", this));
+    controls->addWidget(cmb_shape_);
+    controls->addWidget(btn_clear);
+    controls->addStretch();
+    controls->addWidget(buttons);
+
+    QVBoxLayout* layout = new QVBoxLayout(this);
+    layout->addWidget(editor_, 1);
+    layout->addWidget(lbl_hint);
+    layout->addLayout(controls);
+}
+
+/**
+ * @brief Returns the edited curve
+ */
+BallisticsSettings CurveDialog::settings() const
+{
+    return editor_->settings();
+}
+
+/**
+ * @brief Shape combo box index changed event
+ * @param index new index
+ */
+void CurveDialog::slot_shape_changed(int index)
+{
+    BallisticsSettings settings = editor_->settings();
+    settings.shape = static_cast<CurveShape>(index);
+    editor_->set_settings(settings);
+}
+
+/**
+ * @brief Clear button clicked event, removes every control point
+ */
+void CurveDialog::slot_clear()
+{
+    BallisticsSettings settings;
+    settings.shape = editor_->settings().shape;
+    editor_->set_settings(settings);
+}
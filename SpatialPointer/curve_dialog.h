@@ -0,0 +1,35 @@
+#ifndef CURVE_DIALOG_H
+#define CURVE_DIALOG_H
+
+#include <QDialog>
+#include "ballistics_curve.h"
+
+class QComboBox;
+class CurveEditor;
+
+/**
+ * @brief Dialog editing an acceleration curve, its control points and shape
+ */
+class CurveDialog : public QDialog
+{
+    Q_OBJECT
+
+public:
+
+    explicit CurveDialog(const BallisticsSettings& settings, QWidget *parent = 0);
+
+    BallisticsSettings settings() const;
+
+private slots:
+
+    void slot_shape_changed(int index);
+    void slot_clear();
+
+private:
+
+    CurveEditor* editor_;
+    QComboBox* cmb_shape_;
+
+};
+
+#endif // CURVE_DIALOG_H
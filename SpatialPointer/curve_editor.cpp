@@ -0,0 +1,216 @@
+#include "curve_editor.h"
+#include <QMouseEvent>
+#include <QPainter>
+#include <QPainterPath>
+#include <algorithm>
+
+/**
+ * @brief Initialize
+ * @param parent parent widget
+ */
+CurveEditor::CurveEditor(QWidget *parent) : QWidget(parent), dragging_(-1)
+{
+    setMinimumSize(360, 240);
+    setMouseTracking(true);
+}
+
+/**
+ * @brief Replaces the curve being edited
+ * @param settings new curve
+ */
+void CurveEditor::set_settings(const BallisticsSettings& settings)
+{
+    settings_ = settings;
+    dragging_ = -1;
+    update_curve();
+}
+
+/**
+ * @brief Returns the curve being edited
+ */
+const BallisticsSettings& CurveEditor::settings() const
+{
+    return settings_;
+}
+
+/**
+ * @brief Draws the grid, the curve and its control points
+ * @param event paint event
+ */
+void CurveEditor::paintEvent(QPaintEvent* event)
+{
+    Q_UNUSED(event);
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.fillRect(rect(), Qt::white);
+
+    const QRectF area = plot();
+
+    // Grid every 50 deg/s and every unit of gain
+    painter.setPen(QColor(220, 220, 220));
+    for(int speed = 0; speed <= kMaxSpeed; speed += 50)
+    {
+        painter.drawLine(to_widget(speed, 0.0f), to_widget(speed, kMaxGain));
+        painter.setPen(Qt::darkGray);
+        painter.drawText(QRectF(to_widget(speed, 0.0f) - QPointF(20, -2), QSizeF(40, kMargin / 2)), Qt::AlignCenter, QString::number(speed));
+        painter.setPen(QColor(220, 220, 220));
+    }
+    for(int gain = 0; gain <= kMaxGain; ++gain)
+    {
+        painter.drawLine(to_widget(0.0f, gain), to_widget(kMaxSpeed, gain));
+        painter.setPen(Qt::darkGray);
+        painter.drawText(QRectF(to_widget(0.0f, gain) - QPointF(kMargin, 8), QSizeF(kMargin - 4, 16)), Qt::AlignRight | Qt::AlignVCenter, QString::number(gain) + "x");
+        painter.setPen(QColor(220, 220, 220));
+    }
+
+    painter.setPen(Qt::darkGray);
+    painter.drawRect(area);
+    painter.drawText(QRectF(area.right() - 60, area.bottom() + kMargin / 2, 60, kMargin / 2), Qt::AlignRight | Qt::AlignVCenter, "deg/s");
+
+    // Without control points the pointer is linear, a dashed line shows the unit gain
+    QPainterPath path;
+    for(int x = 0; x <= area.width(); ++x)
+    {
+        const float speed = kMaxSpeed * x / area.width();
+        const QPointF point = to_widget(speed, std::min(curve_.evaluate(speed), kMaxGain));
+        if(x == 0)
+            path.moveTo(point);
+        else
+            path.lineTo(point);
+    }
+    painter.setPen(QPen(QColor(0x00, 0x33, 0x66), 2, curve_.enabled() ? Qt::SolidLine : Qt::DashLine));
+    painter.drawPath(path);
+
+    painter.setPen(Qt::NoPen);
+    for(int i = 0; i < settings_.point_count; ++i)
+    {
+        painter.setBrush(i == dragging_ ? QColor(0xcc, 0x33, 0x00) : QColor(0x00, 0x33, 0x66));
+        painter.drawEllipse(to_widget(settings_.speeds[i], settings_.gains[i]), kPointRadius, kPointRadius);
+    }
+}
+
+/**
+ * @brief Picks up a control point, adds one where there is none or removes one with the right button
+ * @param event mouse event
+ */
+void CurveEditor::mousePressEvent(QMouseEvent* event)
+{
+    const int index = point_at(event->pos());
+
+    if(event->button() == Qt::RightButton)
+    {
+        if(index < 0)
+            return;
+
+        std::copy(settings_.speeds + index + 1, settings_.speeds + settings_.point_count, settings_.speeds + index);
+        std::copy(settings_.gains + index + 1, settings_.gains + settings_.point_count, settings_.gains + index);
+        --settings_.point_count;
+        settings_.speeds[settings_.point_count] = 0.0f;
+        settings_.gains[settings_.point_count] = 0.0f;
+        update_curve();
+        return;
+    }
+
+    if(event->button() != Qt::LeftButton)
+        return;
+
+    if(index >= 0)
+    {
+        dragging_ = index;
+        update();
+        return;
+    }
+
+    if(settings_.point_count == BallisticsSettings::kMaxPoints)
+        return;
+
+    dragging_ = settings_.point_count++;
+    to_curve(event->pos(), settings_.speeds[dragging_], settings_.gains[dragging_]);
+    update_curve();
+}
+
+/**
+ * @brief Moves the control point being dragged
+ * @param event mouse event
+ */
+void CurveEditor::mouseMoveEvent(QMouseEvent* event)
+{
+    if(dragging_ < 0)
+    {
+        setCursor(point_at(event->pos()) >= 0 ? Qt::PointingHandCursor : Qt::CrossCursor);
+        return;
+    }
+
+    to_curve(event->pos(), settings_.speeds[dragging_], settings_.gains[dragging_]);
+    update_curve();
+}
+
+/**
+ * @brief Drops the control point being dragged
+ * @param event mouse event
+ */
+void CurveEditor::mouseReleaseEvent(QMouseEvent* event)
+{
+    Q_UNUSED(event);
+
+    dragging_ = -1;
+    update();
+}
+
+/**
+ * @brief Returns the area of the widget covered by the plot
+ */
+QRectF CurveEditor::plot() const
+{
+    return QRectF(kMargin, kMargin / 2, width() - kMargin * 3 / 2, height() - kMargin * 3 / 2);
+}
+
+/**
+ * @brief Converts a point of the curve into widget coordinates
+ * @param speed angular speed (degrees per second)
+ * @param gain gain at that speed
+ */
+QPointF CurveEditor::to_widget(const float& speed, const float& gain) const
+{
+    const QRectF area = plot();
+    return QPointF(area.left() + area.width() * speed / kMaxSpeed, area.bottom() - area.height() * gain / kMaxGain);
+}
+
+/**
+ * @brief Converts widget coordinates into a point of the curve, clamped to the plot
+ * @param position widget coordinates
+ * @param speed receives the angular speed (degrees per second), rounded to 1 deg/s
+ * @param gain receives the gain, rounded to 0.05
+ */
+void CurveEditor::to_curve(const QPoint& position, float& speed, float& gain) const
+{
+    const QRectF area = plot();
+    speed = qRound(qBound(0.0, (position.x() - area.left()) / area.width(), 1.0) * kMaxSpeed);
+    gain = qRound(qBound(0.0, (area.bottom() - position.y()) / area.height(), 1.0) * kMaxGain * 20.0f) / 20.0f;
+}
+
+/**
+ * @brief Returns the index of the control point under a position, or -1
+ * @param position widget coordinates
+ */
+int CurveEditor::point_at(const QPoint& position) const
+{
+    for(int i = settings_.point_count - 1; i >= 0; --i)
+    {
+        const QPointF offset = to_widget(settings_.speeds[i], settings_.gains[i]) - position;
+        if(offset.x() * offset.x() + offset.y() * offset.y() <= kPickRadius * kPickRadius)
+            return i;
+    }
+    return -1;
+}
+
+/**
+ * @brief Recompiles the curve after an edit and redraws it
+ */
+void CurveEditor::update_curve()
+{
+    curve_.set_settings(settings_);
+    update();
+    emit changed();
+}
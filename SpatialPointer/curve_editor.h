@@ -0,0 +1,60 @@
+#ifndef CURVE_EDITOR_H
+#define CURVE_EDITOR_H
+
+#include <QWidget>
+#include "ballistics_curve.h"
+
+/**
+ * @brief Plot of the acceleration curve whose control points can be added, dragged and removed with the mouse
+ */
+class CurveEditor : public QWidget
+{
+    Q_OBJECT
+
+public:
+
+    explicit CurveEditor(QWidget *parent = 0);
+
+    void set_settings(const BallisticsSettings& settings);
+    const BallisticsSettings& settings() const;
+
+signals:
+
+    void changed();
+
+protected:
+
+    void paintEvent(QPaintEvent* event) override;
+    void mousePressEvent(QMouseEvent* event) override;
+    void mouseMoveEvent(QMouseEvent* event) override;
+    void mouseReleaseEvent(QMouseEvent* event) override;
+
+private:
+
+    // Extent of the plot, angular speed (degrees per second) and gain
+    const float kMaxSpeed = 200.0f;
+    const float kMaxGain = 4.0f;
+
+    // Space around the plot for the axis labels (pixels)
+    const int kMargin = 30;
+
+    // Radius of a control point, and how close a click must be to pick it up (pixels)
+    const int kPointRadius = 4;
+    const int kPickRadius = 8;
+
+    BallisticsSettings settings_;
+    BallisticsCurve curve_;
+
+    // Index of the control point being dragged, or -1
+    int dragging_;
+
+    QRectF plot() const;
+    QPointF to_widget(const float& speed, const float& gain) const;
+    void to_curve(const QPoint& position, float& speed, float& gain) const;
+    int point_at(const QPoint& position) const;
+
+    void update_curve();
+
+};
+
+#endif // CURVE_EDITOR_H
@@ -0,0 +1,92 @@
+#include "dwell_detector.h"
+#include <cstdlib>
+
+DwellDetector::DwellDetector()
+{
+    reset(0, 0, 0.0);
+}
+
+/**
+ * \brief Sets the parameters used for subsequent updates
+ * \param settings new parameters
+ */
+void DwellDetector::set_settings(const DwellSettings& settings)
+{
+    settings_ = settings;
+}
+
+/**
+ * \brief Returns the parameters currently in use
+ */
+const DwellSettings& DwellDetector::settings() const
+{
+    return settings_;
+}
+
+/**
+ * \brief Begins dwelling at the given position
+ * \param x cursor x position
+ * \param y cursor y position
+ * \param time current time (seconds)
+ */
+void DwellDetector::reset(const int& x, const int& y, const double& time)
+{
+    state_ = State::kDwelling;
+    anchor_x_ = x;
+    anchor_y_ = y;
+    anchor_time_ = time;
+    armed_time_ = time;
+}
+
+/**
+ * \brief Advances the detector with the current cursor position
+ * \param x cursor x position
+ * \param y cursor y position
+ * \param time current time (seconds)
+ */
+DwellEvent DwellDetector::update(const int& x, const int& y, const double& time)
+{
+    // Leaving the trigger radius restarts dwelling from the new position
+    if (!settings_.enabled || !within_radius(x, y))
+    {
+        const bool cancelled = state_ == State::kCountdown;
+        reset(x, y, time);
+        return cancelled ? DwellEvent::kCancelled : DwellEvent::kNone;
+    }
+
+    switch (state_)
+    {
+    case State::kDwelling:
+        if (time - anchor_time_ >= settings_.trigger_time)
+        {
+            state_ = State::kCountdown;
+            armed_time_ = time;
+            return DwellEvent::kArmed;
+        }
+        break;
+
+    case State::kCountdown:
+        if (time - armed_time_ >= settings_.click_time)
+        {
+            // Only one click per dwell, the cursor must move away before clicking again
+            state_ = State::kClicked;
+            return DwellEvent::kClick;
+        }
+        break;
+
+    case State::kClicked:
+        break;
+    }
+
+    return DwellEvent::kNone;
+}
+
+/**
+ * \brief Returns true if the position is within the trigger radius of the dwell anchor
+ * \param x cursor x position
+ * \param y cursor y position
+ */
+bool DwellDetector::within_radius(const int& x, const int& y) const
+{
+    return std::abs(x - anchor_x_) < settings_.radius && std::abs(y - anchor_y_) < settings_.radius;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+/**
+ * \brief User adjustable parameters of the dwell click
+ */
+struct DwellSettings
+{
+
+    bool enabled = true;
+
+    // Distance (pixels) the cursor may drift on either axis while dwelling
+    int radius = 0;
+
+    // Time (seconds) the cursor must dwell before the click countdown begins
+    double trigger_time = 0.0;
+
+    // Duration (seconds) of the click countdown
+    double click_time = 0.0;
+
+};
+
+/**
+ * \brief Outcome of a dwell update
+ */
+enum class DwellEvent
+{
+
+    kNone,
+
+    // The cursor has dwelled for the trigger time, the click countdown has begun
+    kArmed,
+
+    // The cursor left the trigger radius during the click countdown
+    kCancelled,
+
+    // The click countdown completed
+    kClick
+
+};
+
+/**
+ * \brief Detects the cursor dwelling in one place and times the resulting click
+ *
+ * The detector is driven purely by the cursor position and the sensor's timestamps so that live
+ * input and recorded sessions produce the same clicks.
+ */
+class DwellDetector
+{
+
+ public:
+
+    DwellDetector();
+
+    void set_settings(const DwellSettings& settings);
+    const DwellSettings& settings() const;
+
+    void reset(const int& x, const int& y, const double& time);
+
+    DwellEvent update(const int& x, const int& y, const double& time);
+
+ private:
+
+    enum class State
+    {
+        kDwelling,
+        kCountdown,
+        kClicked
+    };
+
+    DwellSettings settings_;
+
+    State state_;
+
+    int anchor_x_;
+    int anchor_y_;
+    double anchor_time_;
+    double armed_time_;
+
+    bool within_radius(const int& x, const int& y) const;
+
+};
@@ -0,0 +1,408 @@
+#include "filter_bank.h"
+#include "block_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+
+const double kPi = 3.14159265358979323846;
+
+// Quality factor of a second order Butterworth low-pass filter
+const double kButterworthQ = 0.70710678118654752440;
+
+const SampleBlock::Channel kRateChannels[] = { SampleBlock::kAngularRateX, SampleBlock::kAngularRateY, SampleBlock::kAngularRateZ };
+
+/**
+ * \brief Returns whether two sets of parameters describe the same filter
+ */
+bool same_filter(const FilterSettings& a, const FilterSettings& b)
+{
+    return a.type == b.type && a.sample_rate == b.sample_rate && a.frequency == b.frequency && a.notch_q == b.notch_q
+            && a.length == b.length && a.tap_count == b.tap_count && std::equal(a.taps, a.taps + FilterSettings::kMaxTaps, b.taps)
+            && a.tremor_notch == b.tremor_notch;
+}
+
+}
+
+FilterBank::FilterBank()
+{
+    design();
+    reset();
+}
+
+/**
+ * \brief Sets the filter used for subsequent packets, the state is only reset when the design changes
+ * \param settings new parameters
+ */
+void FilterBank::set_settings(const FilterSettings& settings)
+{
+    if (same_filter(settings, settings_))
+    {
+        return;
+    }
+
+    settings_ = settings;
+    design();
+    reset();
+}
+
+/**
+ * \brief Returns the parameters currently in use
+ */
+const FilterSettings& FilterBank::settings() const
+{
+    return settings_;
+}
+
+/**
+ * \brief Forgets the history of every channel and any detected tremor, the next packet restarts the filters
+ */
+void FilterBank::reset()
+{
+    last_timestamp_ = 0.0;
+    has_timestamp_ = false;
+    primed_ = false;
+    kalman_timestamp_ = 0.0;
+    tremor_.reset();
+    notch_frequency_ = 0.0;
+}
+
+/**
+ * \brief Sets the measurement noise of the Kalman filter, takes effect from the next packet without resetting it
+ * \param variance variance of each axis's angular rate at rest ((degrees per second)^2), zero keeps a typical gyroscope's
+ */
+void FilterBank::set_rate_noise(const Vec3d& variance)
+{
+    kalman_[0].set_measurement_noise(variance.x);
+    kalman_[1].set_measurement_noise(variance.y);
+    kalman_[2].set_measurement_noise(variance.z);
+}
+
+/**
+ * \brief Filters a block of packets in place
+ * \param block packets reported by the PhidgetSpatial, after bias correction
+ */
+void FilterBank::process(SampleBlock& block)
+{
+    if ((settings_.type == FilterType::kNone && !settings_.tremor_notch) || block.count == 0)
+    {
+        return;
+    }
+
+    // Filter each run of continuous packets, the filters restart after a gap in the stream
+    std::size_t begin = 0;
+    for (std::size_t i = 0; i < block.count; ++i)
+    {
+        const double dt = block.timestamp[i] - last_timestamp_;
+        if (has_timestamp_ && !(dt > 0.0 && dt <= kMaxSampleInterval))
+        {
+            process(block, begin, i);
+            primed_ = false;
+            begin = i;
+        }
+        last_timestamp_ = block.timestamp[i];
+        has_timestamp_ = true;
+    }
+    process(block, begin, block.count);
+}
+
+/**
+ * \brief Returns the tremor estimate driving the tremor notch
+ */
+const TremorEstimator& FilterBank::tremor() const
+{
+    return tremor_;
+}
+
+/**
+ * \brief Computes the coefficients of the selected filter
+ */
+void FilterBank::design()
+{
+    biquad_ = Biquad();
+    tap_count_ = 0;
+
+    const double sample_rate = std::max(settings_.sample_rate, 1.0);
+    const double frequency = std::min(std::max(settings_.frequency, 0.01), kMaxFrequency * sample_rate);
+
+    switch (settings_.type)
+    {
+    case FilterType::kLowPass:
+        biquad_ = low_pass(frequency, sample_rate);
+        break;
+    case FilterType::kNotch:
+        biquad_ = notch(frequency, settings_.notch_q, sample_rate);
+        break;
+    case FilterType::kMovingAverage:
+    {
+        tap_count_ = static_cast<std::size_t>(std::min(std::max(settings_.length, 1), static_cast<int>(FilterSettings::kMaxTaps)));
+        std::fill(taps_, taps_ + tap_count_, 1.0f / tap_count_);
+        break;
+    }
+    case FilterType::kKalman:
+        for (int a = 0; a < 3; ++a)
+        {
+            kalman_[a].set_bandwidth(frequency, sample_rate);
+        }
+        break;
+    case FilterType::kFir:
+    {
+        // An empty impulse response passes packets through unchanged
+        tap_count_ = static_cast<std::size_t>(std::min(std::max(settings_.tap_count, 0), static_cast<int>(FilterSettings::kMaxTaps)));
+        std::reverse_copy(settings_.taps, settings_.taps + tap_count_, taps_);
+        break;
+    }
+    default:
+        break;
+    }
+
+    tremor_.set_sample_rate(sample_rate);
+}
+
+/**
+ * \brief Filters a run of continuous packets
+ * \param block packets to filter in place
+ * \param begin index of the first packet of the run
+ * \param end index one past the last packet of the run
+ */
+void FilterBank::process(SampleBlock& block, const std::size_t& begin, const std::size_t& end)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+
+    if (!primed_)
+    {
+        prime(block, begin);
+        primed_ = true;
+    }
+
+    // The tremor is measured before any filtering can attenuate it
+    if (settings_.tremor_notch)
+    {
+        tremor_.update(block, begin, end);
+    }
+
+    const bool convolution = settings_.type == FilterType::kMovingAverage || settings_.type == FilterType::kFir;
+    if (settings_.type == FilterType::kKalman)
+    {
+        estimate_rates(block, begin, end);
+    }
+    else if (settings_.type != FilterType::kNone)
+    {
+        for (std::size_t c = 0; c < SampleBlock::kChannelCount; ++c)
+        {
+            float* values = block.channel(static_cast<SampleBlock::Channel>(c)) + begin;
+            if (convolution)
+            {
+                convolve(values, end - begin, channels_[c]);
+            }
+            else
+            {
+                biquad(values, end - begin, biquad_, channels_[c].z1, channels_[c].z2);
+            }
+        }
+    }
+
+    if (settings_.tremor_notch)
+    {
+        tune_notch(block, begin);
+        if (notch_frequency_ > 0.0)
+        {
+            for (int a = 0; a < 3; ++a)
+            {
+                biquad(block.channel(kRateChannels[a]) + begin, end - begin, notch_, notch_state_[a][0], notch_state_[a][1]);
+            }
+        }
+    }
+}
+
+/**
+ * \brief Sets the state of every channel as if the stream had always held the values of a packet
+ * \param block block holding the packet
+ * \param index index of the packet
+ */
+void FilterBank::prime(const SampleBlock& block, const std::size_t& index)
+{
+    for (std::size_t c = 0; c < SampleBlock::kChannelCount; ++c)
+    {
+        const double value = block.channel(static_cast<SampleBlock::Channel>(c))[index];
+        ChannelState& state = channels_[c];
+        prime_biquad(value, biquad_, state.z1, state.z2);
+        std::fill(state.window, state.window + kHistory, static_cast<float>(value));
+    }
+
+    // The Kalman filters take the packet as it is
+    for (int a = 0; a < 3; ++a)
+    {
+        kalman_[a].reset();
+    }
+
+    // A gap in the stream ends any tremor
+    tremor_.reset();
+    notch_frequency_ = 0.0;
+}
+
+/**
+ * \brief Follows the tremor estimate, switching the notch on and off and retuning it as the tremor's frequency moves
+ * \param block block being filtered, the notch starts from its packet at index
+ * \param index index of the first packet the notch will filter
+ */
+void FilterBank::tune_notch(const SampleBlock& block, const std::size_t& index)
+{
+    if (!tremor_.detected())
+    {
+        notch_frequency_ = 0.0;
+        return;
+    }
+
+    if (std::abs(tremor_.frequency() - notch_frequency_) < kTremorRetune)
+    {
+        return;
+    }
+
+    const double sample_rate = std::max(settings_.sample_rate, 1.0);
+    notch_ = notch(std::min(tremor_.frequency(), kMaxFrequency * sample_rate), kTremorNotchQ, sample_rate);
+
+    // A notch switched on starts steady, one being retuned keeps its state
+    if (notch_frequency_ == 0.0)
+    {
+        for (int a = 0; a < 3; ++a)
+        {
+            prime_biquad(block.channel(kRateChannels[a])[index], notch_, notch_state_[a][0], notch_state_[a][1]);
+        }
+    }
+    notch_frequency_ = tremor_.frequency();
+}
+
+/**
+ * \brief Replaces the angular rate of a run of continuous packets with the Kalman filters' estimate
+ * \param block packets to filter in place
+ * \param begin index of the first packet of the run
+ * \param end index one past the last packet of the run
+ */
+void FilterBank::estimate_rates(SampleBlock& block, const std::size_t& begin, const std::size_t& end)
+{
+    float* rates[3] = { block.channel(kRateChannels[0]), block.channel(kRateChannels[1]), block.channel(kRateChannels[2]) };
+
+    // The filters are recursive and each packet's interval is shared by the axes, they run a packet at a time
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        const double dt = block.timestamp[i] - kalman_timestamp_;
+        kalman_timestamp_ = block.timestamp[i];
+        for (int a = 0; a < 3; ++a)
+        {
+            kalman_[a].update(rates[a][i], dt);
+            rates[a][i] = static_cast<float>(kalman_[a].rate());
+        }
+    }
+}
+
+/**
+ * \brief Designs a second order Butterworth low-pass filter (Audio EQ Cookbook, R. Bristow-Johnson)
+ * \param frequency cut-off (hertz), below the Nyquist frequency
+ * \param sample_rate packets per second
+ */
+FilterBank::Biquad FilterBank::low_pass(const double& frequency, const double& sample_rate)
+{
+    const double omega = 2.0 * kPi * frequency / sample_rate;
+    const double cosine = std::cos(omega);
+    const double alpha = std::sin(omega) / (2.0 * kButterworthQ);
+    const double a0 = 1.0 + alpha;
+
+    Biquad coefficients;
+    coefficients.b0 = (1.0 - cosine) / 2.0 / a0;
+    coefficients.b1 = (1.0 - cosine) / a0;
+    coefficients.b2 = coefficients.b0;
+    coefficients.a1 = -2.0 * cosine / a0;
+    coefficients.a2 = (1.0 - alpha) / a0;
+    return coefficients;
+}
+
+/**
+ * \brief Designs a notch filter (Audio EQ Cookbook, R. Bristow-Johnson)
+ * \param frequency centre (hertz), below the Nyquist frequency
+ * \param q quality factor, higher values remove a narrower band
+ * \param sample_rate packets per second
+ */
+FilterBank::Biquad FilterBank::notch(const double& frequency, const double& q, const double& sample_rate)
+{
+    const double omega = 2.0 * kPi * frequency / sample_rate;
+    const double cosine = std::cos(omega);
+    const double alpha = std::sin(omega) / (2.0 * std::max(q, 0.1));
+    const double a0 = 1.0 + alpha;
+
+    Biquad coefficients;
+    coefficients.b0 = 1.0 / a0;
+    coefficients.b1 = -2.0 * cosine / a0;
+    coefficients.b2 = coefficients.b0;
+    coefficients.a1 = coefficients.b1;
+    coefficients.a2 = (1.0 - alpha) / a0;
+    return coefficients;
+}
+
+/**
+ * \brief Runs a channel through a biquad (transposed direct form II)
+ * \param values values of the channel, filtered in place
+ * \param count number of values
+ * \param coefficients biquad to apply
+ * \param z1 first state variable of the channel
+ * \param z2 second state variable of the channel
+ */
+void FilterBank::biquad(float* values, const std::size_t& count, const Biquad& coefficients, double& z1, double& z2)
+{
+    // Each output depends on the previous one, the recursion runs a packet at a time
+    double s1 = z1;
+    double s2 = z2;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const double input = values[i];
+        const double output = coefficients.b0 * input + s1;
+        s1 = coefficients.b1 * input - coefficients.a1 * output + s2;
+        s2 = coefficients.b2 * input - coefficients.a2 * output;
+        values[i] = static_cast<float>(output);
+    }
+    z1 = s1;
+    z2 = s2;
+}
+
+/**
+ * \brief Sets the state of a biquad as if its input had always been a constant
+ * \param value constant input, which the low-pass and notch designs both pass unchanged
+ * \param coefficients biquad being primed
+ * \param z1 receives the first state variable
+ * \param z2 receives the second state variable
+ */
+void FilterBank::prime_biquad(const double& value, const Biquad& coefficients, double& z1, double& z2)
+{
+    z2 = (coefficients.b2 - coefficients.a2) * value;
+    z1 = (coefficients.b1 - coefficients.a1) * value + z2;
+}
+
+/**
+ * \brief Convolves a channel with the taps
+ * \param values values of the channel, filtered in place
+ * \param count number of values
+ * \param state state of the channel
+ */
+void FilterBank::convolve(float* values, const std::size_t& count, ChannelState& state) const
+{
+    if (tap_count_ == 0)
+    {
+        return;
+    }
+
+    // The window holds the kHistory packets before the block, the taps cover its last tap_count_ - 1
+    std::memcpy(state.window + kHistory, values, count * sizeof(float));
+
+    const float* history = state.window + kHistory - (tap_count_ - 1);
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        values[i] = static_cast<float>(block_dot(taps_, history + i, tap_count_));
+    }
+
+    std::memmove(state.window, state.window + count, kHistory * sizeof(float));
+}
@@ -0,0 +1,173 @@
+#pragma once
+#include <cstddef>
+#include "linear_algebra.h"
+#include "rate_kalman.h"
+#include "sample_block.h"
+#include "tremor_estimator.h"
+
+/**
+ * \brief Smoothing applied to every channel of the PhidgetSpatial stream
+ */
+enum class FilterType
+{
+    kNone,
+    kLowPass,
+    kNotch,
+    kMovingAverage,
+    kFir,
+    kKalman
+};
+
+/**
+ * \brief User adjustable parameters of the filter bank
+ */
+struct FilterSettings
+{
+
+    // Largest number of taps of an FIR filter (or packets of a moving average)
+    static const int kMaxTaps = 64;
+
+    FilterType type = FilterType::kNone;
+
+    // Packets per second the filters are designed for
+    double sample_rate = 125.0;
+
+    // Cut-off of the low-pass filter, centre of the notch or bandwidth of the Kalman filter with a
+    // typical gyroscope's noise (hertz)
+    double frequency = 5.0;
+
+    // Quality factor of the notch, higher values remove a narrower band
+    double notch_q = 2.0;
+
+    // Number of packets averaged by the moving average
+    int length = 8;
+
+    // Impulse response of the FIR filter, oldest packet last
+    int tap_count = 0;
+    float taps[kMaxTaps] = {};
+
+    // Whether a notch follows any tremor detected in the angular rate
+    bool tremor_notch = false;
+
+};
+
+/**
+ * \brief Filters all nine channels of the PhidgetSpatial stream a block at a time
+ *
+ * The low-pass (Butterworth) and notch filters are biquads, the moving average and FIR filters
+ * share a convolution over each channel's recent history. Every channel has its own state, laid
+ * out so that no two channels share a cache line. Filters start from the first packet they see
+ * as if it had always been steady, so a reset does not make the cursor lurch.
+ *
+ * The Kalman filter only estimates the angular rate, a RateKalman per axis tracks the rate and its
+ * derivative and replaces each packet's rate with the estimate. The other channels pass unchanged.
+ * Its process noise is set by the frequency, the filter's bandwidth with a typical gyroscope, and
+ * its measurement noise is the gyroscope's own once it has been measured at rest, so a noisier
+ * gyroscope is smoothed more.
+ *
+ * The tremor notch is independent of the selected filter. A TremorEstimator watches the angular
+ * rate as it enters the bank, and while it detects a tremor a notch tuned to its frequency is
+ * applied to the angular rate as it leaves. The notch is retuned without resetting its state.
+ */
+class FilterBank
+{
+
+ public:
+
+    FilterBank();
+
+    void set_settings(const FilterSettings& settings);
+    const FilterSettings& settings() const;
+
+    void reset();
+
+    void set_rate_noise(const Vec3d& variance);
+
+    void process(SampleBlock& block);
+
+    const TremorEstimator& tremor() const;
+
+ private:
+
+    // Gaps between packets longer than this (seconds) are treated as a restart of the stream
+    const double kMaxSampleInterval = 0.25;
+
+    // Highest design frequency as a proportion of the sample rate, just below the Nyquist frequency
+    const double kMaxFrequency = 0.45;
+
+    static const std::size_t kHistory = FilterSettings::kMaxTaps - 1;
+
+    // Quality factor of the tremor notch, wide enough to cover a tremor's wandering frequency
+    const double kTremorNotchQ = 2.0;
+
+    // Smallest change of the tremor's frequency (hertz) that retunes the notch
+    const double kTremorRetune = 0.05;
+
+    /**
+     * \brief Normalized coefficients of a biquad
+     */
+    struct Biquad
+    {
+
+        double b0 = 1.0;
+        double b1 = 0.0;
+        double b2 = 0.0;
+        double a1 = 0.0;
+        double a2 = 0.0;
+
+    };
+
+    /**
+     * \brief Filter state of a single channel
+     */
+    struct alignas(64) ChannelState
+    {
+
+        // Biquad state (transposed direct form II)
+        double z1;
+        double z2;
+
+        // The last taps - 1 packets followed by the block being filtered
+        float window[kHistory + SampleBlock::kCapacity];
+
+    };
+
+    FilterSettings settings_;
+
+    Biquad biquad_;
+
+    // Convolution taps in time order (oldest packet first)
+    float taps_[FilterSettings::kMaxTaps];
+    std::size_t tap_count_;
+
+    ChannelState channels_[SampleBlock::kChannelCount];
+
+    double last_timestamp_;
+    bool has_timestamp_;
+    bool primed_;
+
+    // Angular rate estimate of each axis and the timestamp of the last packet it has seen
+    RateKalman kalman_[3];
+    double kalman_timestamp_;
+
+    // Tremor notch of each angular rate channel, active while a tremor is detected
+    TremorEstimator tremor_;
+    Biquad notch_;
+    double notch_frequency_;
+    double notch_state_[3][2];
+
+    void design();
+    void tune_notch(const SampleBlock& block, const std::size_t& index);
+    void estimate_rates(SampleBlock& block, const std::size_t& begin, const std::size_t& end);
+
+    void process(SampleBlock& block, const std::size_t& begin, const std::size_t& end);
+    void prime(const SampleBlock& block, const std::size_t& index);
+
+    static Biquad low_pass(const double& frequency, const double& sample_rate);
+    static Biquad notch(const double& frequency, const double& q, const double& sample_rate);
+
+    static void biquad(float* values, const std::size_t& count, const Biquad& coefficients, double& z1, double& z2);
+    static void prime_biquad(const double& value, const Biquad& coefficients, double& z1, double& z2);
+    void convolve(float* values, const std::size_t& count, ChannelState& state) const;
+
+};
@@ -0,0 +1,257 @@
+#include "gyro_bias_estimator.h"
+#include "block_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace
+{
+
+/**
+ * \brief Returns the standard deviation of a window from its sum and sum of squares
+ */
+double deviation(const double& sum, const double& square_sum, const int& count)
+{
+    const double mean = sum / count;
+    return std::sqrt(std::max(square_sum / count - mean * mean, 0.0));
+}
+
+}
+
+GyroBiasEstimator::GyroBiasEstimator()
+{
+    reset();
+}
+
+/**
+ * \brief Forgets the bias and restarts stillness detection
+ */
+void GyroBiasEstimator::reset()
+{
+    bias_ = Vec3d();
+    calibrated_ = false;
+    noise_ = Vec3d();
+    noise_measured_ = false;
+    still_ = false;
+    previous_mean_ = Vec3d();
+    previous_field_ = Vec3d();
+    previous_field_valid_ = false;
+    previous_still_ = false;
+    disagreements_ = 0;
+    has_timestamp_ = false;
+    clear_window(0.0);
+}
+
+/**
+ * \brief Adds a block of packets to the current window, re-estimating the bias whenever a window completes
+ * \param block packets reported by the PhidgetSpatial, before correction
+ */
+void GyroBiasEstimator::update(const SampleBlock& block)
+{
+    if (block.count == 0)
+    {
+        return;
+    }
+
+    // Zero intervals mark a restart of the stream, including before the first packet
+    float intervals[SampleBlock::kCapacity];
+    block_intervals(block.timestamp, block.count, has_timestamp_ ? last_timestamp_ : std::numeric_limits<double>::quiet_NaN(), kMaxSampleInterval, intervals);
+
+    float magnitudes[SampleBlock::kCapacity];
+    block_length(block.channel(SampleBlock::kAccelerationX), block.channel(SampleBlock::kAccelerationY), block.channel(SampleBlock::kAccelerationZ), block.count, magnitudes);
+
+    float strengths[SampleBlock::kCapacity];
+    block_length(block.channel(SampleBlock::kMagneticFieldX), block.channel(SampleBlock::kMagneticFieldY), block.channel(SampleBlock::kMagneticFieldZ), block.count, strengths);
+
+    // Split the block into runs of packets that belong to the same window, each run is added at once
+    std::size_t begin = 0;
+    for (std::size_t i = 0; i < block.count; ++i)
+    {
+        // Windows never span a restart of the stream
+        if (intervals[i] == 0.0f)
+        {
+            previous_still_ = false;
+            clear_window(block.timestamp[i]);
+            begin = i;
+        }
+
+        if (block.timestamp[i] - window_start_ >= kWindow)
+        {
+            accumulate(block, magnitudes, strengths, begin, i + 1);
+            close_window();
+            clear_window(block.timestamp[i]);
+            begin = i + 1;
+        }
+    }
+    accumulate(block, magnitudes, strengths, begin, block.count);
+
+    last_timestamp_ = block.timestamp[block.count - 1];
+    has_timestamp_ = true;
+}
+
+/**
+ * \brief Subtracts the estimated bias from the angular rate of a block of packets
+ * \param block packets to correct
+ */
+void GyroBiasEstimator::correct(SampleBlock& block) const
+{
+    block_add(block.channel(SampleBlock::kAngularRateX), block.count, static_cast<float>(-bias_.x));
+    block_add(block.channel(SampleBlock::kAngularRateY), block.count, static_cast<float>(-bias_.y));
+    block_add(block.channel(SampleBlock::kAngularRateZ), block.count, static_cast<float>(-bias_.z));
+}
+
+/**
+ * \brief Returns the estimated bias of each axis (degrees per second)
+ */
+const Vec3d& GyroBiasEstimator::bias() const
+{
+    return bias_;
+}
+
+/**
+ * \brief Returns whether the most recent window was still
+ */
+bool GyroBiasEstimator::still() const
+{
+    return still_;
+}
+
+/**
+ * \brief Returns the variance of each axis's angular rate at rest ((degrees per second)^2), zero until measured
+ */
+const Vec3d& GyroBiasEstimator::noise() const
+{
+    return noise_;
+}
+
+/**
+ * \brief Returns whether the bias has been measured at least once
+ */
+bool GyroBiasEstimator::calibrated() const
+{
+    return calibrated_;
+}
+
+/**
+ * \brief Adds a run of packets to the current window's sums
+ * \param block packets reported by the PhidgetSpatial
+ * \param magnitudes magnitude of each packet's acceleration
+ * \param strengths magnitude of each packet's magnetic field
+ * \param begin index of the first packet of the run
+ * \param end index one past the last packet of the run
+ */
+void GyroBiasEstimator::accumulate(const SampleBlock& block, const float* magnitudes, const float* strengths, const std::size_t& begin, const std::size_t& end)
+{
+    if (end <= begin)
+    {
+        return;
+    }
+
+    const std::size_t count = end - begin;
+    count_ += static_cast<int>(count);
+
+    block_moments(block.channel(SampleBlock::kAngularRateX) + begin, count, rate_sum_.x, rate_square_sum_.x);
+    block_moments(block.channel(SampleBlock::kAngularRateY) + begin, count, rate_sum_.y, rate_square_sum_.y);
+    block_moments(block.channel(SampleBlock::kAngularRateZ) + begin, count, rate_sum_.z, rate_square_sum_.z);
+    block_moments(magnitudes + begin, count, acceleration_sum_, acceleration_square_sum_);
+
+    // Saturated or missing compass readings are skipped individually
+    const float* field_x = block.channel(SampleBlock::kMagneticFieldX);
+    const float* field_y = block.channel(SampleBlock::kMagneticFieldY);
+    const float* field_z = block.channel(SampleBlock::kMagneticFieldZ);
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        if (strengths[i] > 0.0f && strengths[i] <= kMaxMagneticField)
+        {
+            field_sum_ += Vec3d(field_x[i], field_y[i], field_z[i]);
+            ++field_count_;
+        }
+    }
+}
+
+/**
+ * \brief Starts a new window
+ * \param timestamp hardware timestamp of the window's first packet (seconds)
+ */
+void GyroBiasEstimator::clear_window(const double& timestamp)
+{
+    window_start_ = timestamp;
+    count_ = 0;
+    rate_sum_ = Vec3d();
+    rate_square_sum_ = Vec3d();
+    acceleration_sum_ = 0.0;
+    acceleration_square_sum_ = 0.0;
+    field_sum_ = Vec3d();
+    field_count_ = 0;
+}
+
+/**
+ * \brief Classifies the completed window and, if it is trusted, moves the bias towards its mean
+ */
+void GyroBiasEstimator::close_window()
+{
+    if (count_ < 2)
+    {
+        still_ = false;
+        previous_still_ = false;
+        return;
+    }
+
+    const Vec3d mean(rate_sum_.x / count_, rate_sum_.y / count_, rate_sum_.z / count_);
+
+    // Only compare fields when both windows were mostly made of valid compass readings
+    const bool field_valid = field_count_ * 2 >= count_;
+    const Vec3d field = field_valid ? Vec3d(field_sum_.x / field_count_, field_sum_.y / field_count_, field_sum_.z / field_count_) : Vec3d();
+    const bool field_agrees = !field_valid || !previous_field_valid_
+            || std::sqrt((field.x - previous_field_.x) * (field.x - previous_field_.x)
+                         + (field.y - previous_field_.y) * (field.y - previous_field_.y)
+                         + (field.z - previous_field_.z) * (field.z - previous_field_.z)) <= kStillFieldAgreement;
+
+    still_ = deviation(rate_sum_.x, rate_square_sum_.x, count_) <= kStillRateDeviation
+            && deviation(rate_sum_.y, rate_square_sum_.y, count_) <= kStillRateDeviation
+            && deviation(rate_sum_.z, rate_square_sum_.z, count_) <= kStillRateDeviation
+            && deviation(acceleration_sum_, acceleration_square_sum_, count_) <= kStillAccelerationDeviation
+            && std::abs(mean.x) <= kMaxBias && std::abs(mean.y) <= kMaxBias && std::abs(mean.z) <= kMaxBias;
+
+    const bool trusted = still_ && previous_still_ && field_agrees
+            && std::abs(mean.x - previous_mean_.x) <= kStillRateAgreement
+            && std::abs(mean.y - previous_mean_.y) <= kStillRateAgreement
+            && std::abs(mean.z - previous_mean_.z) <= kStillRateAgreement;
+
+    const bool close = std::abs(mean.x - bias_.x) <= kMaxBiasChange
+            && std::abs(mean.y - bias_.y) <= kMaxBiasChange
+            && std::abs(mean.z - bias_.z) <= kMaxBiasChange;
+
+    disagreements_ = trusted && calibrated_ && !close ? disagreements_ + 1 : 0;
+    const bool recalibrate = disagreements_ >= kRecalibrateWindows;
+
+    if (trusted && (!calibrated_ || close || recalibrate))
+    {
+        // The first measurement (or one that has persistently disagreed) is taken as is, later
+        // ones refine it
+        const double rate = calibrated_ && !recalibrate ? kLearningRate : 1.0;
+        bias_.x += (mean.x - bias_.x) * rate;
+        bias_.y += (mean.y - bias_.y) * rate;
+        bias_.z += (mean.z - bias_.z) * rate;
+        calibrated_ = true;
+        disagreements_ = 0;
+    }
+
+    // The noise does not drift like the bias, every trusted window refines it
+    if (trusted)
+    {
+        const double x = deviation(rate_sum_.x, rate_square_sum_.x, count_);
+        const double y = deviation(rate_sum_.y, rate_square_sum_.y, count_);
+        const double z = deviation(rate_sum_.z, rate_square_sum_.z, count_);
+        const double rate = noise_measured_ ? kLearningRate : 1.0;
+        noise_.x += (x * x - noise_.x) * rate;
+        noise_.y += (y * y - noise_.y) * rate;
+        noise_.z += (z * z - noise_.z) * rate;
+        noise_measured_ = true;
+    }
+
+    previous_mean_ = mean;
+    previous_field_ = field;
+    previous_field_valid_ = field_valid;
+    previous_still_ = still_;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include <cstddef>
+#include "linear_algebra.h"
+#include "sample_block.h"
+
+/**
+ * \brief Learns the gyroscope's per-axis bias whenever the sensor is still
+ *
+ * Packets are gathered into short windows by hardware timestamp. A window counts as still when the
+ * angular rate of every axis and the magnitude of the acceleration barely vary across it. Slow
+ * intentional rotation can be as steady as a bias, so a window is only trusted when the one before
+ * it was also still and agrees with it, including on the direction of the magnetic field. Once
+ * calibrated, the bias is only nudged towards windows close to it, a persistent disagreement is
+ * needed before it is replaced. The estimate is subtracted from every packet before the deadzone,
+ * so the deadzone no longer has to be wide enough to hide the bias. The spread of the angular rate
+ * across the same trusted windows is the gyroscope's noise, which is learned the same way and
+ * tunes the filter bank's Kalman filter to the device at hand. Packets are processed a block
+ * at a time, the window sums are accumulated a channel at a time with the block kernels.
+ */
+class GyroBiasEstimator
+{
+
+ public:
+
+    GyroBiasEstimator();
+
+    void reset();
+
+    void update(const SampleBlock& block);
+    void correct(SampleBlock& block) const;
+
+    const Vec3d& bias() const;
+    const Vec3d& noise() const;
+    bool still() const;
+    bool calibrated() const;
+
+ private:
+
+    // Length of each stillness window (seconds)
+    const double kWindow = 0.5;
+
+    // Largest standard deviation of the angular rate of each axis (degrees per second) and of the
+    // acceleration's magnitude (g) across a still window, above the PhidgetSpatial's noise floor
+    const double kStillRateDeviation = 0.5;
+    const double kStillAccelerationDeviation = 0.01;
+
+    // Largest difference between the mean angular rates of consecutive still windows (degrees per second)
+    const double kStillRateAgreement = 0.2;
+
+    // Largest difference between the mean magnetic fields of consecutive still windows (gauss),
+    // well above the noise of a window's mean but below half a degree of rotation in a typical field
+    const double kStillFieldAgreement = 0.0015;
+
+    // Compass readings beyond this magnitude (gauss) are saturated or unknown
+    const double kMaxMagneticField = 10.0;
+
+    // Means beyond this (degrees per second) are rotation rather than bias
+    const double kMaxBias = 5.0;
+
+    // Once calibrated, still windows further than this from the estimate (degrees per second) are
+    // more likely slow rotation than a change of bias, unless they persist for kRecalibrateWindows
+    const double kMaxBiasChange = 0.5;
+    const int kRecalibrateWindows = 6;
+
+    // Proportion of the difference between the estimate and a still window's mean applied per window
+    const double kLearningRate = 0.2;
+
+    // Gaps between packets longer than this (seconds) are treated as a restart of the stream
+    const double kMaxSampleInterval = 0.25;
+
+    Vec3d bias_;
+    bool calibrated_;
+
+    // Variance of each axis's angular rate at rest, zero until measured
+    Vec3d noise_;
+    bool noise_measured_;
+    bool still_;
+
+    // Mean angular rate and magnetic field of the previous window, valid while previous_still_ is set
+    Vec3d previous_mean_;
+    Vec3d previous_field_;
+    bool previous_field_valid_;
+    bool previous_still_;
+
+    // Consecutive trusted windows that disagreed with the estimate
+    int disagreements_;
+
+    // Running sums of the current window
+    double window_start_;
+    double last_timestamp_;
+    bool has_timestamp_;
+    int count_;
+    Vec3d rate_sum_;
+    Vec3d rate_square_sum_;
+    double acceleration_sum_;
+    double acceleration_square_sum_;
+    Vec3d field_sum_;
+    int field_count_;
+
+    void accumulate(const SampleBlock& block, const float* magnitudes, const float* strengths, const std::size_t& begin, const std::size_t& end);
+    void clear_window(const double& timestamp);
+    void close_window();
+
+};
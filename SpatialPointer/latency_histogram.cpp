@@ -0,0 +1,173 @@
+#include "latency_histogram.h"
+#include <cmath>
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+LatencyHistogram::LatencyHistogram()
+{
+    reset();
+}
+
+/**
+ * \brief Records a single latency (recording thread only)
+ * \param value latency (nanoseconds), negative values are recorded as zero
+ */
+void LatencyHistogram::record(std::int64_t value)
+{
+    if (value < 0)
+    {
+        value = 0;
+    }
+
+    counts_[bucket_index(static_cast<std::uint64_t>(value))].fetch_add(1, std::memory_order_relaxed);
+    total_.fetch_add(1, std::memory_order_relaxed);
+
+    if (value > max_.load(std::memory_order_relaxed))
+    {
+        max_.store(value, std::memory_order_relaxed);
+    }
+}
+
+/**
+ * \brief Clears every recorded value
+ */
+void LatencyHistogram::reset()
+{
+    for (int i = 0; i < kBuckets; ++i)
+    {
+        counts_[i].store(0, std::memory_order_relaxed);
+    }
+    total_.store(0, std::memory_order_relaxed);
+    max_.store(0, std::memory_order_relaxed);
+}
+
+/**
+ * \brief Returns the number of recorded values
+ */
+std::uint64_t LatencyHistogram::count() const
+{
+    return total_.load(std::memory_order_relaxed);
+}
+
+/**
+ * \brief Returns the largest recorded value (nanoseconds)
+ */
+std::int64_t LatencyHistogram::max() const
+{
+    return max_.load(std::memory_order_relaxed);
+}
+
+/**
+ * \brief Returns the value (nanoseconds) at or below which the given percentage of values fall
+ * \param percentile percentage in the range 0 - 100
+ */
+std::int64_t LatencyHistogram::percentile(const double& percentile) const
+{
+    const std::uint64_t total = count();
+    if (total == 0)
+    {
+        return 0;
+    }
+
+    std::uint64_t target = static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * total));
+    if (target < 1)
+    {
+        target = 1;
+    }
+
+    std::uint64_t cumulative = 0;
+    for (int i = 0; i < kBuckets; ++i)
+    {
+        cumulative += counts_[i].load(std::memory_order_relaxed);
+        if (cumulative >= target)
+        {
+            const std::int64_t upper = static_cast<std::int64_t>(bucket_upper_bound(i));
+            return upper < max() ? upper : max();
+        }
+    }
+    return max();
+}
+
+/**
+ * \brief Writes a percentile summary followed by every non-empty bucket
+ * \param stream destination
+ * \param name name of the measured interval
+ */
+void LatencyHistogram::write(std::ostream& stream, const char* name) const
+{
+    stream << "# " << name << "\n";
+    stream << "count " << count() << "\n";
+    stream << "p50 " << percentile(50.0) << "\n";
+    stream << "p99 " << percentile(99.0) << "\n";
+    stream << "p99.9 " << percentile(99.9) << "\n";
+    stream << "max " << max() << "\n";
+    stream << "# lower_bound_ns upper_bound_ns count\n";
+    for (int i = 0; i < kBuckets; ++i)
+    {
+        const std::uint64_t bucket_count = counts_[i].load(std::memory_order_relaxed);
+        if (bucket_count > 0)
+        {
+            stream << bucket_lower_bound(i) << " " << bucket_upper_bound(i) << " " << bucket_count << "\n";
+        }
+    }
+    stream << "\n";
+}
+
+/**
+ * \brief Returns the bucket a value falls into
+ * \param value value (nanoseconds)
+ */
+int LatencyHistogram::bucket_index(std::uint64_t value)
+{
+    const std::uint64_t kMaxValue = (static_cast<std::uint64_t>(1) << kValueBits) - 1;
+    if (value > kMaxValue)
+    {
+        value = kMaxValue;
+    }
+
+    // Values below two sub-bucket ranges are stored exactly
+    if (value < static_cast<std::uint64_t>(2 * kSubBuckets))
+    {
+        return static_cast<int>(value);
+    }
+
+#ifdef _MSC_VER
+    unsigned long most_significant_bit;
+    _BitScanReverse64(&most_significant_bit, value);
+#else
+    const int most_significant_bit = 63 - __builtin_clzll(value);
+#endif
+
+    const int shift = static_cast<int>(most_significant_bit) - kSubBucketBits;
+    return kSubBuckets * shift + static_cast<int>(value >> shift);
+}
+
+/**
+ * \brief Returns the smallest value (nanoseconds) stored in a bucket
+ * \param index bucket index
+ */
+std::uint64_t LatencyHistogram::bucket_lower_bound(const int& index)
+{
+    if (index < 2 * kSubBuckets)
+    {
+        return static_cast<std::uint64_t>(index);
+    }
+
+    const int shift = index / kSubBuckets - 1;
+    const std::uint64_t sub_bucket = static_cast<std::uint64_t>(index - kSubBuckets * shift);
+    return sub_bucket << shift;
+}
+
+/**
+ * \brief Returns the largest value (nanoseconds) stored in a bucket
+ * \param index bucket index
+ */
+std::uint64_t LatencyHistogram::bucket_upper_bound(const int& index)
+{
+    if (index + 1 >= kBuckets)
+    {
+        return (static_cast<std::uint64_t>(1) << kValueBits) - 1;
+    }
+    return bucket_lower_bound(index + 1) - 1;
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <ostream>
+
+/**
+ * \brief Fixed size log-linear histogram of latencies (nanoseconds) in the style of HdrHistogram
+ *
+ * Values are exact below 64 ns, above that each power of two is split into 32 buckets giving a
+ * worst case error of about 3%. Recording is wait-free and allocation free, a single thread may
+ * record while any other thread reads percentiles.
+ */
+class LatencyHistogram
+{
+
+ public:
+
+    LatencyHistogram();
+
+    void record(std::int64_t value);
+    void reset();
+
+    std::uint64_t count() const;
+    std::int64_t max() const;
+    std::int64_t percentile(const double& percentile) const;
+
+    void write(std::ostream& stream, const char* name) const;
+
+ private:
+
+    static const int kSubBucketBits = 5;
+    static const int kSubBuckets = 1 << kSubBucketBits;
+
+    // Values are clamped to 2^40 ns (roughly 18 minutes)
+    static const int kValueBits = 40;
+    static const int kBuckets = kSubBuckets * (kValueBits - kSubBucketBits + 1);
+
+    std::atomic<std::uint64_t> counts_[kBuckets];
+    std::atomic<std::uint64_t> total_;
+    std::atomic<std::int64_t> max_;
+
+    static int bucket_index(std::uint64_t value);
+    static std::uint64_t bucket_lower_bound(const int& index);
+    static std::uint64_t bucket_upper_bound(const int& index);
+
+};
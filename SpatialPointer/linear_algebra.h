@@ -0,0 +1,269 @@
+#pragma once
+#include <cmath>
+
+/**
+ * \brief Small fixed size vector, matrix and quaternion types
+ *
+ * Every type is a plain aggregate of its components with value semantics: operators return new
+ * values rather than modifying their operands, and everything that does not need a square root or
+ * trigonometry is constexpr. Vec3 has exactly the layout of three consecutive components, so arrays
+ * of samples can be handed to the batch kernels in vector_kernels.h.
+ */
+
+template<class T>
+struct Vec3
+{
+
+    T x;
+    T y;
+    T z;
+
+    constexpr Vec3() : x(0), y(0), z(0) {}
+    constexpr Vec3(const T &x, const T &y, const T &z) : x(x), y(y), z(z) {}
+
+    template<class U>
+    constexpr explicit Vec3(const Vec3<U> &v) : x(static_cast<T>(v.x)), y(static_cast<T>(v.y)), z(static_cast<T>(v.z)) {}
+
+    Vec3& operator+=(const Vec3 &v) { x += v.x; y += v.y; z += v.z; return *this; }
+    Vec3& operator-=(const Vec3 &v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+    Vec3& operator*=(const T &scalar) { x *= scalar; y *= scalar; z *= scalar; return *this; }
+    Vec3& operator/=(const T &scalar) { x /= scalar; y /= scalar; z /= scalar; return *this; }
+
+};
+
+template<class T>
+struct Vec4
+{
+
+    T x;
+    T y;
+    T z;
+    T w;
+
+    constexpr Vec4() : x(0), y(0), z(0), w(0) {}
+    constexpr Vec4(const T &x, const T &y, const T &z, const T &w) : x(x), y(y), z(z), w(w) {}
+    constexpr Vec4(const Vec3<T> &v, const T &w) : x(v.x), y(v.y), z(v.z), w(w) {}
+
+    constexpr Vec3<T> xyz() const { return Vec3<T>(x, y, z); }
+
+    Vec4& operator+=(const Vec4 &v) { x += v.x; y += v.y; z += v.z; w += v.w; return *this; }
+    Vec4& operator-=(const Vec4 &v) { x -= v.x; y -= v.y; z -= v.z; w -= v.w; return *this; }
+    Vec4& operator*=(const T &scalar) { x *= scalar; y *= scalar; z *= scalar; w *= scalar; return *this; }
+
+};
+
+/**
+ * \brief 3x3 matrix stored as rows
+ */
+template<class T>
+struct Mat3
+{
+
+    Vec3<T> r0;
+    Vec3<T> r1;
+    Vec3<T> r2;
+
+    constexpr Mat3() : r0(1, 0, 0), r1(0, 1, 0), r2(0, 0, 1) {}
+    constexpr Mat3(const Vec3<T> &r0, const Vec3<T> &r1, const Vec3<T> &r2) : r0(r0), r1(r1), r2(r2) {}
+
+    static constexpr Mat3 identity() { return Mat3(); }
+    static constexpr Mat3 diagonal(const Vec3<T> &d) { return Mat3(Vec3<T>(d.x, 0, 0), Vec3<T>(0, d.y, 0), Vec3<T>(0, 0, d.z)); }
+
+    constexpr Vec3<T> c0() const { return Vec3<T>(r0.x, r1.x, r2.x); }
+    constexpr Vec3<T> c1() const { return Vec3<T>(r0.y, r1.y, r2.y); }
+    constexpr Vec3<T> c2() const { return Vec3<T>(r0.z, r1.z, r2.z); }
+
+    constexpr Mat3 transposed() const { return Mat3(c0(), c1(), c2()); }
+
+};
+
+/**
+ * \brief Quaternion w + xi + yj + zk, as a unit quaternion it represents a rotation
+ */
+template<class T>
+struct Quat
+{
+
+    T w;
+    T x;
+    T y;
+    T z;
+
+    constexpr Quat() : w(1), x(0), y(0), z(0) {}
+    constexpr Quat(const T &w, const T &x, const T &y, const T &z) : w(w), x(x), y(y), z(z) {}
+
+    static constexpr Quat identity() { return Quat(); }
+
+    constexpr Vec3<T> vector() const { return Vec3<T>(x, y, z); }
+    constexpr Quat conjugate() const { return Quat(w, -x, -y, -z); }
+
+    constexpr Quat operator*(const Quat &q) const
+    {
+        return Quat(w * q.w - x * q.x - y * q.y - z * q.z,
+                    w * q.x + x * q.w + y * q.z - z * q.y,
+                    w * q.y - x * q.z + y * q.w + z * q.x,
+                    w * q.z + x * q.y - y * q.x + z * q.w);
+    }
+
+    /**
+     * \brief Rotates a vector (from the sensor frame into the earth frame for an orientation)
+     */
+    constexpr Vec3<T> rotate(const Vec3<T> &v) const;
+
+    /**
+     * \brief Rotation matrix equivalent to rotate(), cheaper when applied to many vectors
+     */
+    constexpr Mat3<T> to_matrix() const
+    {
+        return Mat3<T>(Vec3<T>(1 - 2 * (y * y + z * z), 2 * (x * y - w * z), 2 * (x * z + w * y)),
+                       Vec3<T>(2 * (x * y + w * z), 1 - 2 * (x * x + z * z), 2 * (y * z - w * x)),
+                       Vec3<T>(2 * (x * z - w * y), 2 * (y * z + w * x), 1 - 2 * (x * x + y * y)));
+    }
+
+    /**
+     * \brief Heading about the earth's vertical axis (radians, ZYX convention)
+     */
+    T yaw() const { return std::atan2(2 * (w * z + x * y), 1 - 2 * (y * y + z * z)); }
+
+    /**
+     * \brief Elevation (radians, ZYX convention)
+     */
+    T pitch() const
+    {
+        const T sine = 2 * (w * y - z * x);
+        return std::asin(sine > 1 ? T(1) : (sine < -1 ? T(-1) : sine));
+    }
+
+    /**
+     * \brief Rotation about the sensor's forward axis (radians, ZYX convention)
+     */
+    T roll() const { return std::atan2(2 * (w * x + y * z), 1 - 2 * (x * x + y * y)); }
+
+};
+
+typedef Vec3<float> Vec3f;
+typedef Vec3<double> Vec3d;
+typedef Vec4<float> Vec4f;
+typedef Vec4<double> Vec4d;
+typedef Mat3<float> Mat3f;
+typedef Mat3<double> Mat3d;
+typedef Quat<float> Quatf;
+typedef Quat<double> Quatd;
+
+static_assert(sizeof(Vec3f) == 3 * sizeof(float) && sizeof(Vec3d) == 3 * sizeof(double), "Vec3 must be tightly packed for the batch kernels");
+
+// Vec3
+
+template<class T> constexpr Vec3<T> operator+(const Vec3<T> &a, const Vec3<T> &b) { return Vec3<T>(a.x + b.x, a.y + b.y, a.z + b.z); }
+template<class T> constexpr Vec3<T> operator-(const Vec3<T> &a, const Vec3<T> &b) { return Vec3<T>(a.x - b.x, a.y - b.y, a.z - b.z); }
+template<class T> constexpr Vec3<T> operator-(const Vec3<T> &v) { return Vec3<T>(-v.x, -v.y, -v.z); }
+template<class T> constexpr Vec3<T> operator*(const Vec3<T> &v, const T &scalar) { return Vec3<T>(v.x * scalar, v.y * scalar, v.z * scalar); }
+template<class T> constexpr Vec3<T> operator*(const T &scalar, const Vec3<T> &v) { return v * scalar; }
+template<class T> constexpr Vec3<T> operator/(const Vec3<T> &v, const T &scalar) { return Vec3<T>(v.x / scalar, v.y / scalar, v.z / scalar); }
+template<class T> constexpr bool operator==(const Vec3<T> &a, const Vec3<T> &b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+template<class T> constexpr bool operator!=(const Vec3<T> &a, const Vec3<T> &b) { return !(a == b); }
+
+/**
+ * \brief Component-wise product
+ */
+template<class T> constexpr Vec3<T> hadamard(const Vec3<T> &a, const Vec3<T> &b) { return Vec3<T>(a.x * b.x, a.y * b.y, a.z * b.z); }
+
+template<class T> constexpr T dot(const Vec3<T> &a, const Vec3<T> &b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+template<class T> constexpr Vec3<T> cross(const Vec3<T> &a, const Vec3<T> &b) { return Vec3<T>(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x); }
+template<class T> constexpr T length_squared(const Vec3<T> &v) { return dot(v, v); }
+template<class T> T length(const Vec3<T> &v) { return std::sqrt(length_squared(v)); }
+
+/**
+ * \brief Returns the vector scaled to unit length, a vector with no direction is returned unchanged
+ */
+template<class T>
+Vec3<T> normalized(const Vec3<T> &v)
+{
+    const T size = length(v);
+    return size > 0 && std::isfinite(size) ? v / size : v;
+}
+
+// Vec4
+
+template<class T> constexpr Vec4<T> operator+(const Vec4<T> &a, const Vec4<T> &b) { return Vec4<T>(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w); }
+template<class T> constexpr Vec4<T> operator-(const Vec4<T> &a, const Vec4<T> &b) { return Vec4<T>(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w); }
+template<class T> constexpr Vec4<T> operator-(const Vec4<T> &v) { return Vec4<T>(-v.x, -v.y, -v.z, -v.w); }
+template<class T> constexpr Vec4<T> operator*(const Vec4<T> &v, const T &scalar) { return Vec4<T>(v.x * scalar, v.y * scalar, v.z * scalar, v.w * scalar); }
+template<class T> constexpr Vec4<T> operator*(const T &scalar, const Vec4<T> &v) { return v * scalar; }
+template<class T> constexpr bool operator==(const Vec4<T> &a, const Vec4<T> &b) { return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w; }
+template<class T> constexpr bool operator!=(const Vec4<T> &a, const Vec4<T> &b) { return !(a == b); }
+
+template<class T> constexpr T dot(const Vec4<T> &a, const Vec4<T> &b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+template<class T> T length(const Vec4<T> &v) { return std::sqrt(dot(v, v)); }
+
+// Mat3
+
+template<class T> constexpr Vec3<T> operator*(const Mat3<T> &m, const Vec3<T> &v) { return Vec3<T>(dot(m.r0, v), dot(m.r1, v), dot(m.r2, v)); }
+
+template<class T>
+constexpr Mat3<T> operator*(const Mat3<T> &a, const Mat3<T> &b)
+{
+    return Mat3<T>(Vec3<T>(dot(a.r0, b.c0()), dot(a.r0, b.c1()), dot(a.r0, b.c2())),
+                   Vec3<T>(dot(a.r1, b.c0()), dot(a.r1, b.c1()), dot(a.r1, b.c2())),
+                   Vec3<T>(dot(a.r2, b.c0()), dot(a.r2, b.c1()), dot(a.r2, b.c2())));
+}
+
+template<class T> constexpr Mat3<T> operator+(const Mat3<T> &a, const Mat3<T> &b) { return Mat3<T>(a.r0 + b.r0, a.r1 + b.r1, a.r2 + b.r2); }
+template<class T> constexpr Mat3<T> operator-(const Mat3<T> &a, const Mat3<T> &b) { return Mat3<T>(a.r0 - b.r0, a.r1 - b.r1, a.r2 - b.r2); }
+template<class T> constexpr Mat3<T> operator*(const Mat3<T> &m, const T &scalar) { return Mat3<T>(m.r0 * scalar, m.r1 * scalar, m.r2 * scalar); }
+
+template<class T> constexpr T determinant(const Mat3<T> &m) { return dot(m.r0, cross(m.r1, m.r2)); }
+
+// Quat
+
+template<class T>
+constexpr Vec3<T> Quat<T>::rotate(const Vec3<T> &v) const
+{
+    // v + 2w(u x v) + 2u x (u x v), where u is the vector part
+    return v + cross(vector(), v) * (2 * w) + cross(vector(), cross(vector(), v)) * T(2);
+}
+
+template<class T> constexpr T dot(const Quat<T> &a, const Quat<T> &b) { return a.w * b.w + a.x * b.x + a.y * b.y + a.z * b.z; }
+template<class T> T norm(const Quat<T> &q) { return std::sqrt(dot(q, q)); }
+
+/**
+ * \brief Returns the quaternion scaled to unit length, or the identity if it has degenerated
+ */
+template<class T>
+Quat<T> normalized(const Quat<T> &q)
+{
+    const T size = norm(q);
+    if (!(size > 0) || !std::isfinite(size))
+    {
+        return Quat<T>();
+    }
+    return Quat<T>(q.w / size, q.x / size, q.y / size, q.z / size);
+}
+
+/**
+ * \brief Rotation of angle (radians) about a unit axis
+ */
+template<class T>
+Quat<T> axis_angle(const Vec3<T> &axis, const T &angle)
+{
+    const T half = angle / 2;
+    const T sine = std::sin(half);
+    return Quat<T>(std::cos(half), axis.x * sine, axis.y * sine, axis.z * sine);
+}
+
+/**
+ * \brief Normalized linear interpolation between two orientations along the shorter arc, a cheap
+ * approximation of slerp for small steps
+ * \param from orientation at t = 0
+ * \param to orientation at t = 1
+ * \param t interpolation factor
+ */
+template<class T>
+Quat<T> nlerp(const Quat<T> &from, const Quat<T> &to, const T &t)
+{
+    const T sign = dot(from, to) < 0 ? T(-1) : T(1);
+    return normalized(Quat<T>(from.w + (sign * to.w - from.w) * t,
+                              from.x + (sign * to.x - from.x) * t,
+                              from.y + (sign * to.y - from.y) * t,
+                              from.z + (sign * to.z - from.z) * t));
+}
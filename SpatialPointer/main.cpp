@@ -1,11 +1,117 @@
 #include "spatial_pointer.h"
+#include "phidget_spatial.h"
+#include "qt_cursor_output.h"
+#include "replay_spatial.h"
+#include "session_recorder.h"
+#include "simulated_spatial.h"
+#include "uinput_cursor_output.h"
 #include <QApplication>
+#include <QCommandLineParser>
+#include <algorithm>
+#include <memory>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
-    SpatialPointer w;
-    w.show();
 
-    return a.exec();
+    // Identifies where QSettings keeps the acceleration profiles
+    QApplication::setOrganizationName("Pointy");
+    QApplication::setApplicationName("Pointy");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Control your mouse cursor with a Phidget Spatial");
+    parser.addHelpOption();
+
+    QCommandLineOption simulate_option("simulate", "Use synthetic sensor data instead of a Phidget Spatial.");
+    QCommandLineOption rate_option("simulate-rate", "Synthetic packets per second.", "hz", "125");
+    QCommandLineOption burst_option("simulate-burst", "Synthetic packets delivered per callback.", "packets", "1");
+    QCommandLineOption noise_option("simulate-noise", "Synthetic gyroscope noise standard deviation (deg/s).", "deg/s", "0.05");
+    QCommandLineOption bias_option("simulate-bias", "Synthetic gyroscope bias on every axis (deg/s).", "deg/s", "0");
+    QCommandLineOption replay_option("replay", "Replay a recorded session instead of using a Phidget Spatial.", "file");
+    QCommandLineOption speed_option("replay-speed", "Replay speed multiplier (0 = as fast as possible).", "factor", "1");
+    QCommandLineOption record_option("record", "Record every sensor packet to a session file.", "file");
+    QCommandLineOption output_option("output", "Cursor output, qt or uinput (a Linux virtual mouse, needs write access to /dev/uinput).", "output", "qt");
+    QCommandLineOption output_rate_option("output-rate", "Cursor moves per second, packets (a move per burst of packets), refresh (the fastest monitor's refresh rate) or a number, e.g. 1000.", "rate", "packets");
+    QCommandLineOption no_prediction_option("no-output-prediction", "Do not lead coalesced cursor moves by the time they were held back.");
+    parser.addOptions({ simulate_option, rate_option, burst_option, noise_option, bias_option, replay_option, speed_option, record_option, output_option,
+                        output_rate_option, no_prediction_option });
+    parser.process(a);
+
+    // Replace the hardware with a synthetic source for benchmarking without a sensor attatched
+    std::unique_ptr<SimulatedSpatial> simulator;
+    if(parser.isSet(simulate_option))
+    {
+        SimulationSettings settings;
+        settings.rate = parser.value(rate_option).toDouble();
+        settings.burst = parser.value(burst_option).toInt();
+        settings.gyro_noise = parser.value(noise_option).toDouble();
+        const double bias = parser.value(bias_option).toDouble();
+        settings.gyro_bias = Vec3d(bias, bias, bias);
+
+        simulator.reset(new SimulatedSpatial(settings));
+        PhidgetSpatial::instance()->set_source(simulator.get());
+    }
+
+    // Replace the hardware with a recorded session
+    std::unique_ptr<ReplaySpatial> replay;
+    if(parser.isSet(replay_option))
+    {
+        replay.reset(new ReplaySpatial(parser.value(replay_option).toStdString(), parser.value(speed_option).toDouble()));
+        PhidgetSpatial::instance()->set_source(replay.get());
+    }
+
+    SessionRecorder recorder;
+    if(parser.isSet(record_option))
+    {
+        if(recorder.open(parser.value(record_option).toStdString()))
+            PhidgetSpatial::instance()->set_recorder(&recorder);
+        else
+            qWarning("Unable to create the session file %s", qPrintable(parser.value(record_option)));
+    }
+
+    // Move the cursor through Qt unless a virtual mouse was asked for and could be created
+    QtCursorOutput qt_output;
+    UinputCursorOutput uinput_output;
+    CursorOutput* output = &qt_output;
+    if(parser.value(output_option) == "uinput")
+    {
+        if(uinput_output.open())
+            output = &uinput_output;
+        else
+            qWarning("Unable to create a uinput virtual mouse, moving the cursor through Qt instead");
+    }
+    else if(parser.value(output_option) != "qt")
+    {
+        qWarning("Unknown cursor output %s, moving the cursor through Qt instead", qPrintable(parser.value(output_option)));
+    }
+    output->open();
+
+    int result;
+    {
+        SpatialPointer w(output);
+
+        // Moves beyond what the display shows are coalesced, a rate that is not understood keeps a move per burst
+        OutputSettings output_settings;
+        output_settings.prediction = !parser.isSet(no_prediction_option);
+        const QString output_rate = parser.value(output_rate_option);
+        bool valid_rate = true;
+        if(output_rate != "packets" && output_rate != "refresh")
+            output_settings.rate = std::max(output_rate.toDouble(&valid_rate), 0.0);
+        if(!valid_rate)
+            qWarning("Unknown output rate %s, moving the cursor once per burst of packets instead", qPrintable(output_rate));
+        w.set_output_settings(output_settings, output_rate == "refresh");
+
+        w.show();
+
+        result = a.exec();
+    }
+
+    output->close();
+
+    // Packets must stop arriving before the recorder goes, a callback may still hold on to it
+    PhidgetSpatial::instance()->close();
+    PhidgetSpatial::instance()->set_recorder(nullptr);
+    recorder.close();
+    PhidgetSpatial::instance()->set_source(nullptr);
+    return result;
 }
@@ -0,0 +1,147 @@
+#include "memory_mapped_file.h"
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MemoryMappedFile::MemoryMappedFile() : data_(nullptr), size_(0), file_(INVALID_HANDLE_VALUE), mapping_(nullptr)
+{
+}
+
+#else
+
+MemoryMappedFile::MemoryMappedFile() : data_(nullptr), size_(0), file_(-1)
+{
+}
+
+#endif
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    close();
+}
+
+/**
+ * \brief Maps the given file into memory, returns false if it could not be mapped
+ * \param path path of the file
+ */
+bool MemoryMappedFile::open(const std::string& path)
+{
+    close();
+
+#ifdef _WIN32
+    file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file_, &size) || size.QuadPart == 0)
+    {
+        close();
+        return false;
+    }
+
+    mapping_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (mapping_ == nullptr)
+    {
+        close();
+        return false;
+    }
+
+    data_ = static_cast<const unsigned char*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+    if (data_ == nullptr)
+    {
+        close();
+        return false;
+    }
+    size_ = static_cast<std::size_t>(size.QuadPart);
+#else
+    file_ = ::open(path.c_str(), O_RDONLY);
+    if (file_ < 0)
+    {
+        return false;
+    }
+
+    struct stat status;
+    if (fstat(file_, &status) != 0 || status.st_size == 0)
+    {
+        close();
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ, MAP_PRIVATE, file_, 0);
+    if (data == MAP_FAILED)
+    {
+        close();
+        return false;
+    }
+
+    // Sessions are read front to back
+    madvise(data, static_cast<std::size_t>(status.st_size), MADV_SEQUENTIAL);
+
+    data_ = static_cast<const unsigned char*>(data);
+    size_ = static_cast<std::size_t>(status.st_size);
+#endif
+
+    return true;
+}
+
+/**
+ * \brief Unmaps the file
+ */
+void MemoryMappedFile::close()
+{
+#ifdef _WIN32
+    if (data_ != nullptr)
+    {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_ != nullptr)
+    {
+        CloseHandle(mapping_);
+        mapping_ = nullptr;
+    }
+    if (file_ != INVALID_HANDLE_VALUE)
+    {
+        CloseHandle(file_);
+        file_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    if (data_ != nullptr)
+    {
+        munmap(const_cast<unsigned char*>(data_), size_);
+    }
+    if (file_ >= 0)
+    {
+        ::close(file_);
+        file_ = -1;
+    }
+#endif
+
+    data_ = nullptr;
+    size_ = 0;
+}
+
+/**
+ * \brief Returns the mapped contents of the file
+ */
+const unsigned char* MemoryMappedFile::data() const
+{
+    return data_;
+}
+
+/**
+ * \brief Returns the size of the mapped file (bytes)
+ */
+std::size_t MemoryMappedFile::size() const
+{
+    return size_;
+}
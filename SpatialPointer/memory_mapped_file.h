@@ -0,0 +1,37 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+/**
+ * \brief Read-only memory mapping of an entire file
+ */
+class MemoryMappedFile
+{
+
+ public:
+
+    MemoryMappedFile();
+    ~MemoryMappedFile();
+
+    MemoryMappedFile(const MemoryMappedFile&) = delete;
+    MemoryMappedFile& operator=(const MemoryMappedFile&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const unsigned char* data() const;
+    std::size_t size() const;
+
+ private:
+
+    const unsigned char* data_;
+    std::size_t size_;
+
+#ifdef _WIN32
+    void* file_;
+    void* mapping_;
+#else
+    int file_;
+#endif
+
+};
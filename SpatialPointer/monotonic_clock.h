@@ -0,0 +1,11 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+/**
+ * \brief Returns the current time of the monotonic clock (nanoseconds since an unspecified epoch)
+ */
+inline std::int64_t monotonic_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
@@ -0,0 +1,73 @@
+#include "one_euro_filter.h"
+#include <cmath>
+
+namespace
+{
+
+const double kPi = 3.14159265358979323846;
+
+}
+
+OneEuroFilter::OneEuroFilter()
+{
+    reset();
+}
+
+/**
+ * \brief Discards the filter's state, movement not yet handed out is lost
+ */
+void OneEuroFilter::reset()
+{
+    lag_ = 0.0;
+    velocity_ = 0.0;
+    has_velocity_ = false;
+}
+
+/**
+ * \brief Advances the filter by one packet
+ * \param velocity unfiltered velocity of the axis (pixels per second)
+ * \param dt time elapsed since the previous packet (seconds)
+ * \param min_cutoff cut-off while the cursor is still (hertz)
+ * \param beta increase of the cut-off per pixel per second of speed (hertz)
+ * \return distance (pixels) the filtered position moved
+ */
+double OneEuroFilter::step(const double& velocity, const double& dt, const double& min_cutoff, const double& beta)
+{
+    lag_ += velocity * dt;
+
+    if (has_velocity_)
+    {
+        velocity_ += smoothing_factor(kDerivativeCutoff, dt) * (velocity - velocity_);
+    }
+    else
+    {
+        velocity_ = velocity;
+        has_velocity_ = true;
+    }
+
+    const double cutoff = min_cutoff + beta * std::abs(velocity_);
+    const double movement = smoothing_factor(cutoff, dt) * lag_;
+    lag_ -= movement;
+    return movement;
+}
+
+/**
+ * \brief Resets the filter, returning the movement (pixels) it was still holding back
+ */
+double OneEuroFilter::flush()
+{
+    const double movement = lag_;
+    reset();
+    return movement;
+}
+
+/**
+ * \brief Returns the proportion of the difference between input and output applied in one packet
+ * \param cutoff cut-off (hertz)
+ * \param dt time elapsed since the previous packet (seconds)
+ */
+double OneEuroFilter::smoothing_factor(const double& cutoff, const double& dt)
+{
+    const double tau = 1.0 / (2.0 * kPi * cutoff);
+    return 1.0 / (1.0 + tau / dt);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+/**
+ * \brief Speed dependent smoothing of a cursor axis (the 1€ filter of Casiez, Roussel and Vogel)
+ *
+ * The cursor position is low-pass filtered with a cut-off that rises with the filtered speed, so a
+ * resting cursor is heavily smoothed while a fast one barely lags. The pointer produces velocities
+ * rather than positions, so the filter tracks how far its output trails the integrated velocity
+ * and returns how far the output moves at each packet, the positions themselves never grow.
+ */
+class OneEuroFilter
+{
+
+ public:
+
+    OneEuroFilter();
+
+    void reset();
+
+    double step(const double& velocity, const double& dt, const double& min_cutoff, const double& beta);
+    double flush();
+
+ private:
+
+    // Cut-off (hertz) of the low-pass filter applied to the speed that drives the main cut-off
+    const double kDerivativeCutoff = 1.0;
+
+    // Distance (pixels) the filtered position trails the integrated velocity
+    double lag_;
+
+    // Filtered velocity (pixels per second)
+    double velocity_;
+    bool has_velocity_;
+
+    static double smoothing_factor(const double& cutoff, const double& dt);
+
+};
@@ -0,0 +1,351 @@
+#include "orientation_filter.h"
+#include <cmath>
+
+namespace
+{
+
+const double kRadiansPerDegree = 3.14159265358979323846 / 180.0;
+
+/**
+ * \brief Scales a vector to unit length, returns false if it has no usable direction
+ */
+bool normalize(double& x, double& y, double& z)
+{
+    const double length = std::sqrt(x * x + y * y + z * z);
+    if (!(length > 0.0) || !std::isfinite(length))
+    {
+        return false;
+    }
+
+    x /= length;
+    y /= length;
+    z /= length;
+    return true;
+}
+
+}
+
+OrientationFilter::OrientationFilter()
+{
+    reset();
+}
+
+/**
+ * \brief Sets the parameters used for subsequent packets
+ * \param settings new parameters
+ */
+void OrientationFilter::set_settings(const OrientationSettings& settings)
+{
+    settings_ = settings;
+}
+
+/**
+ * \brief Returns the parameters currently in use
+ */
+const OrientationSettings& OrientationFilter::settings() const
+{
+    return settings_;
+}
+
+/**
+ * \brief Returns to the identity orientation and discards the time base and bias estimate
+ */
+void OrientationFilter::reset()
+{
+    orientation_ = Quatd();
+    integral_x_ = 0.0;
+    integral_y_ = 0.0;
+    integral_z_ = 0.0;
+    last_timestamp_ = 0.0;
+    has_timestamp_ = false;
+    aligned_ = false;
+}
+
+/**
+ * \brief Fuses a packet into the orientation estimate
+ * \param sample packet reported by the PhidgetSpatial
+ */
+void OrientationFilter::update(const SpatialSample& sample)
+{
+    const double dt = sample.timestamp - last_timestamp_;
+    const bool continuous = has_timestamp_ && dt > 0.0 && dt <= kMaxSampleInterval;
+
+    last_timestamp_ = sample.timestamp;
+    has_timestamp_ = true;
+
+    // The Phidget reports gravity as -1g on z when lying flat, both algorithms expect the reaction
+    // to gravity (pointing up)
+    double ax = -sample.acceleration.x;
+    double ay = -sample.acceleration.y;
+    double az = -sample.acceleration.z;
+
+    double mx = sample.magnetic_field.x;
+    double my = sample.magnetic_field.y;
+    double mz = sample.magnetic_field.z;
+
+    const bool use_accelerometer = normalize(ax, ay, az);
+    const double field = std::sqrt(mx * mx + my * my + mz * mz);
+    const bool use_magnetometer = use_accelerometer && settings_.use_magnetometer && field <= kMaxMagneticField && normalize(mx, my, mz);
+
+    // Start from the orientation measured by gravity and the compass rather than converging on it
+    // from the identity, which would take several seconds at typical gains
+    if (!aligned_ && use_accelerometer)
+    {
+        align(ax, ay, az, mx, my, mz, use_magnetometer);
+        aligned_ = true;
+        return;
+    }
+
+    // The first packet of a stream (or after a gap) only establishes the time base
+    if (!continuous)
+    {
+        return;
+    }
+
+    const double gx = sample.angular_rate.x * kRadiansPerDegree;
+    const double gy = sample.angular_rate.y * kRadiansPerDegree;
+    const double gz = sample.angular_rate.z * kRadiansPerDegree;
+
+    // Without gravity there is nothing to correct against, integrate the gyroscope alone
+    if (!use_accelerometer)
+    {
+        integrate_rate(gx, gy, gz, dt);
+        return;
+    }
+
+    if (settings_.algorithm == FusionAlgorithm::kMahony)
+    {
+        update_mahony(gx, gy, gz, ax, ay, az, mx, my, mz, use_magnetometer, dt);
+    }
+    else
+    {
+        update_madgwick(gx, gy, gz, ax, ay, az, mx, my, mz, use_magnetometer, dt);
+    }
+}
+
+/**
+ * \brief Returns the current orientation, rotating the sensor frame into the earth frame
+ */
+const Quatd& OrientationFilter::orientation() const
+{
+    return orientation_;
+}
+
+/**
+ * \brief Returns the gyroscope bias learnt by the Mahony integral term (degrees per second)
+ */
+Vec3d OrientationFilter::gyro_bias() const
+{
+    return Vec3d(-integral_x_ / kRadiansPerDegree, -integral_y_ / kRadiansPerDegree, -integral_z_ / kRadiansPerDegree);
+}
+
+/**
+ * \brief Madgwick gradient descent update, steps the gyroscope integration towards the orientation
+ * that best aligns the measured gravity (and magnetic field) with their earth frame references
+ * \param gx, gy, gz angular rate (radians per second)
+ * \param ax, ay, az normalized acceleration
+ * \param mx, my, mz normalized magnetic field, ignored unless use_magnetometer is set
+ * \param dt time since the previous packet (seconds)
+ */
+void OrientationFilter::update_madgwick(double gx, double gy, double gz, double ax, double ay, double az, double mx, double my, double mz, const bool& use_magnetometer, const double& dt)
+{
+    const double q0 = orientation_.w;
+    const double q1 = orientation_.x;
+    const double q2 = orientation_.y;
+    const double q3 = orientation_.z;
+
+    // Rate of change of the quaternion from the gyroscope
+    double dq0 = 0.5 * (-q1 * gx - q2 * gy - q3 * gz);
+    double dq1 = 0.5 * (q0 * gx + q2 * gz - q3 * gy);
+    double dq2 = 0.5 * (q0 * gy - q1 * gz + q3 * gx);
+    double dq3 = 0.5 * (q0 * gz + q1 * gy - q2 * gx);
+
+    const double q0q1 = q0 * q1;
+    const double q0q2 = q0 * q2;
+    const double q0q3 = q0 * q3;
+    const double q1q1 = q1 * q1;
+    const double q1q2 = q1 * q2;
+    const double q1q3 = q1 * q3;
+    const double q2q2 = q2 * q2;
+    const double q2q3 = q2 * q3;
+    const double q3q3 = q3 * q3;
+
+    double s0;
+    double s1;
+    double s2;
+    double s3;
+
+    if (use_magnetometer)
+    {
+        // Reference direction of the earth's magnetic field, leveled into the x-z plane
+        const double hx = 2.0 * (mx * (0.5 - q2q2 - q3q3) + my * (q1q2 - q0q3) + mz * (q1q3 + q0q2));
+        const double hy = 2.0 * (mx * (q1q2 + q0q3) + my * (0.5 - q1q1 - q3q3) + mz * (q2q3 - q0q1));
+        const double bx = std::sqrt(hx * hx + hy * hy);
+        const double bz = 2.0 * (mx * (q1q3 - q0q2) + my * (q2q3 + q0q1) + mz * (0.5 - q1q1 - q2q2));
+
+        // Objective function: predicted minus measured gravity and field
+        const double fg_x = 2.0 * (q1q3 - q0q2) - ax;
+        const double fg_y = 2.0 * (q0q1 + q2q3) - ay;
+        const double fg_z = 1.0 - 2.0 * (q1q1 + q2q2) - az;
+        const double fb_x = bx * (0.5 - q2q2 - q3q3) + bz * (q1q3 - q0q2) - mx;
+        const double fb_y = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3) - my;
+        const double fb_z = bx * (q0q2 + q1q3) + bz * (0.5 - q1q1 - q2q2) - mz;
+
+        // Gradient, the transposed Jacobian multiplied by the objective function
+        s0 = -2.0 * q2 * fg_x + 2.0 * q1 * fg_y
+                - bz * q2 * fb_x + (-bx * q3 + bz * q1) * fb_y + bx * q2 * fb_z;
+        s1 = 2.0 * q3 * fg_x + 2.0 * q0 * fg_y - 4.0 * q1 * fg_z
+                + bz * q3 * fb_x + (bx * q2 + bz * q0) * fb_y + (bx * q3 - 2.0 * bz * q1) * fb_z;
+        s2 = -2.0 * q0 * fg_x + 2.0 * q3 * fg_y - 4.0 * q2 * fg_z
+                + (-2.0 * bx * q2 - bz * q0) * fb_x + (bx * q1 + bz * q3) * fb_y + (bx * q0 - 2.0 * bz * q2) * fb_z;
+        s3 = 2.0 * q1 * fg_x + 2.0 * q2 * fg_y
+                + (-2.0 * bx * q3 + bz * q1) * fb_x + (-bx * q0 + bz * q2) * fb_y + bx * q1 * fb_z;
+    }
+    else
+    {
+        const double fg_x = 2.0 * (q1q3 - q0q2) - ax;
+        const double fg_y = 2.0 * (q0q1 + q2q3) - ay;
+        const double fg_z = 1.0 - 2.0 * (q1q1 + q2q2) - az;
+
+        s0 = -2.0 * q2 * fg_x + 2.0 * q1 * fg_y;
+        s1 = 2.0 * q3 * fg_x + 2.0 * q0 * fg_y - 4.0 * q1 * fg_z;
+        s2 = -2.0 * q0 * fg_x + 2.0 * q3 * fg_y - 4.0 * q2 * fg_z;
+        s3 = 2.0 * q1 * fg_x + 2.0 * q2 * fg_y;
+    }
+
+    // Step along the normalized gradient, a zero gradient means the estimate is already aligned
+    const double step = std::sqrt(s0 * s0 + s1 * s1 + s2 * s2 + s3 * s3);
+    if (step > 0.0)
+    {
+        const double gain = settings_.beta / step;
+        dq0 -= gain * s0;
+        dq1 -= gain * s1;
+        dq2 -= gain * s2;
+        dq3 -= gain * s3;
+    }
+
+    orientation_ = Quatd(q0 + dq0 * dt, q1 + dq1 * dt, q2 + dq2 * dt, q3 + dq3 * dt);
+    orientation_ = normalized(orientation_);
+}
+
+/**
+ * \brief Mahony complementary filter update, corrects the angular rate with proportional and
+ * integral feedback on the error between the measured and predicted gravity (and magnetic field)
+ * \param gx, gy, gz angular rate (radians per second)
+ * \param ax, ay, az normalized acceleration
+ * \param mx, my, mz normalized magnetic field, ignored unless use_magnetometer is set
+ * \param dt time since the previous packet (seconds)
+ */
+void OrientationFilter::update_mahony(double gx, double gy, double gz, double ax, double ay, double az, double mx, double my, double mz, const bool& use_magnetometer, const double& dt)
+{
+    const double q0 = orientation_.w;
+    const double q1 = orientation_.x;
+    const double q2 = orientation_.y;
+    const double q3 = orientation_.z;
+
+    const double q0q1 = q0 * q1;
+    const double q0q2 = q0 * q2;
+    const double q0q3 = q0 * q3;
+    const double q1q1 = q1 * q1;
+    const double q1q2 = q1 * q2;
+    const double q1q3 = q1 * q3;
+    const double q2q2 = q2 * q2;
+    const double q2q3 = q2 * q3;
+    const double q3q3 = q3 * q3;
+
+    // Predicted direction of gravity in the sensor frame (halved)
+    const double vx = q1q3 - q0q2;
+    const double vy = q0q1 + q2q3;
+    const double vz = 0.5 - q1q1 - q2q2;
+
+    // Error is the cross product between the measured and predicted directions
+    double ex = ay * vz - az * vy;
+    double ey = az * vx - ax * vz;
+    double ez = ax * vy - ay * vx;
+
+    if (use_magnetometer)
+    {
+        const double hx = 2.0 * (mx * (0.5 - q2q2 - q3q3) + my * (q1q2 - q0q3) + mz * (q1q3 + q0q2));
+        const double hy = 2.0 * (mx * (q1q2 + q0q3) + my * (0.5 - q1q1 - q3q3) + mz * (q2q3 - q0q1));
+        const double bx = std::sqrt(hx * hx + hy * hy);
+        const double bz = 2.0 * (mx * (q1q3 - q0q2) + my * (q2q3 + q0q1) + mz * (0.5 - q1q1 - q2q2));
+
+        // Predicted direction of the magnetic field in the sensor frame (halved)
+        const double wx = bx * (0.5 - q2q2 - q3q3) + bz * (q1q3 - q0q2);
+        const double wy = bx * (q1q2 - q0q3) + bz * (q0q1 + q2q3);
+        const double wz = bx * (q0q2 + q1q3) + bz * (0.5 - q1q1 - q2q2);
+
+        ex += my * wz - mz * wy;
+        ey += mz * wx - mx * wz;
+        ez += mx * wy - my * wx;
+    }
+
+    // The integral term converges on the gyroscope bias
+    if (settings_.ki > 0.0)
+    {
+        integral_x_ += 2.0 * settings_.ki * ex * dt;
+        integral_y_ += 2.0 * settings_.ki * ey * dt;
+        integral_z_ += 2.0 * settings_.ki * ez * dt;
+        gx += integral_x_;
+        gy += integral_y_;
+        gz += integral_z_;
+    }
+    else
+    {
+        integral_x_ = 0.0;
+        integral_y_ = 0.0;
+        integral_z_ = 0.0;
+    }
+
+    gx += 2.0 * settings_.kp * ex;
+    gy += 2.0 * settings_.kp * ey;
+    gz += 2.0 * settings_.kp * ez;
+
+    integrate_rate(gx, gy, gz, dt);
+}
+
+/**
+ * \brief Sets the orientation directly from a single measurement of gravity and the magnetic field
+ * \param ax, ay, az normalized acceleration
+ * \param mx, my, mz normalized magnetic field, ignored unless use_magnetometer is set
+ */
+void OrientationFilter::align(const double& ax, const double& ay, const double& az, const double& mx, const double& my, const double& mz, const bool& use_magnetometer)
+{
+    // Shortest rotation taking the measured gravity onto the earth's vertical, upside down is a
+    // half turn about x
+    orientation_ = az > -1.0 + 1.0e-9 ? Quatd(1.0 + az, ay, -ax, 0.0) : Quatd(0.0, 1.0, 0.0, 0.0);
+    orientation_ = normalized(orientation_);
+
+    // Turn about the vertical so that the horizontal component of the field points along x, the
+    // reference direction both algorithms assume
+    if (use_magnetometer)
+    {
+        const Vec3d field = orientation_.rotate(Vec3d(mx, my, mz));
+        const double heading = std::atan2(field.y, field.x);
+        orientation_ = Quatd(std::cos(-heading * 0.5), 0.0, 0.0, std::sin(-heading * 0.5)) * orientation_;
+        orientation_ = normalized(orientation_);
+    }
+}
+
+/**
+ * \brief Rotates the orientation by an angular rate over an interval
+ * \param gx, gy, gz angular rate (radians per second)
+ * \param dt interval (seconds)
+ */
+void OrientationFilter::integrate_rate(const double& gx, const double& gy, const double& gz, const double& dt)
+{
+    const double q0 = orientation_.w;
+    const double q1 = orientation_.x;
+    const double q2 = orientation_.y;
+    const double q3 = orientation_.z;
+
+    const double hx = 0.5 * gx * dt;
+    const double hy = 0.5 * gy * dt;
+    const double hz = 0.5 * gz * dt;
+
+    orientation_ = Quatd(q0 - q1 * hx - q2 * hy - q3 * hz,
+                              q1 + q0 * hx + q2 * hz - q3 * hy,
+                              q2 + q0 * hy - q1 * hz + q3 * hx,
+                              q3 + q0 * hz + q1 * hy - q2 * hx);
+    orientation_ = normalized(orientation_);
+}
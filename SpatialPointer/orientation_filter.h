@@ -0,0 +1,93 @@
+#pragma once
+#include "linear_algebra.h"
+#include "spatial_sample.h"
+
+/**
+ * \brief Sensor fusion algorithms supported by the OrientationFilter
+ */
+enum class FusionAlgorithm
+{
+    kMadgwick,
+    kMahony
+};
+
+/**
+ * \brief User adjustable parameters of the orientation estimate
+ */
+struct OrientationSettings
+{
+
+    FusionAlgorithm algorithm = FusionAlgorithm::kMadgwick;
+
+    // Madgwick gradient descent gain, trades gyro drift correction against accelerometer noise
+    double beta = 0.1;
+
+    // Mahony proportional and integral gains
+    double kp = 1.0;
+    double ki = 0.02;
+
+    // Corrects heading drift with the compass, disable near strong magnetic interference
+    bool use_magnetometer = true;
+
+};
+
+/**
+ * \brief Streaming AHRS that fuses the PhidgetSpatial's gyroscope, accelerometer and compass into
+ * a drift corrected orientation
+ *
+ * The gyroscope is integrated over the Phidget's hardware timestamps, the same as PointerMotion,
+ * while the accelerometer (gravity) corrects pitch and roll and the compass corrects heading.
+ * Packets whose accelerometer or compass readings are unusable fall back to the remaining sensors.
+ * Every update is a fixed handful of floating point operations with no allocation, so the filter
+ * runs on every packet at the full data rate.
+ */
+class OrientationFilter
+{
+
+ public:
+
+    OrientationFilter();
+
+    void set_settings(const OrientationSettings& settings);
+    const OrientationSettings& settings() const;
+
+    void reset();
+
+    void update(const SpatialSample& sample);
+
+    const Quatd& orientation() const;
+
+    Vec3d gyro_bias() const;
+
+ private:
+
+    // Gaps between packets longer than this (seconds) are treated as a restart of the stream
+    const double kMaxSampleInterval = 0.25;
+
+    // Compass readings beyond this magnitude (gauss) are saturated or unknown, the earth's field is
+    // at most ~0.65 gauss
+    const double kMaxMagneticField = 10.0;
+
+    OrientationSettings settings_;
+
+    Quatd orientation_;
+
+    // Mahony integral feedback, an estimate of the gyroscope bias (radians per second)
+    double integral_x_;
+    double integral_y_;
+    double integral_z_;
+
+    double last_timestamp_;
+    bool has_timestamp_;
+
+    // Whether the orientation has been initialized from gravity and the compass
+    bool aligned_;
+
+    void update_madgwick(double gx, double gy, double gz, double ax, double ay, double az, double mx, double my, double mz, const bool& use_magnetometer, const double& dt);
+    void update_mahony(double gx, double gy, double gz, double ax, double ay, double az, double mx, double my, double mz, const bool& use_magnetometer, const double& dt);
+
+    void align(const double& ax, const double& ay, const double& az, const double& mx, const double& my, const double& mz, const bool& use_magnetometer);
+
+    void integrate_rate(const double& gx, const double& gy, const double& gz, const double& dt);
+
+};
@@ -0,0 +1,156 @@
+#include "output_coalescer.h"
+#include <cmath>
+
+const double OutputCoalescer::kVelocitySmoothing = 0.5;
+
+OutputCoalescer::OutputCoalescer() : period_(0.0)
+{
+    reset();
+}
+
+/**
+ * \brief Sets the cadence, a new rate takes effect from the next move
+ * \param settings new parameters
+ */
+void OutputCoalescer::set_settings(const OutputSettings& settings)
+{
+    if (settings.rate != settings_.rate)
+    {
+        // The next move is released straight away and the new cadence counts from it
+        next_flush_ = -HUGE_VAL;
+    }
+
+    settings_ = settings;
+    period_ = settings.rate > 0.0 ? 1.0 / settings.rate : 0.0;
+}
+
+/**
+ * \brief Returns the parameters currently in use
+ */
+const OutputSettings& OutputCoalescer::settings() const
+{
+    return settings_;
+}
+
+/**
+ * \brief Discards the held displacement, the lead and the measured velocity
+ */
+void OutputCoalescer::reset()
+{
+    held_x_ = 0;
+    held_y_ = 0;
+    holding_ = false;
+    lead_x_ = 0;
+    lead_y_ = 0;
+    velocity_x_ = 0.0;
+    velocity_y_ = 0.0;
+    last_flush_ = 0.0;
+    next_flush_ = -HUGE_VAL;
+    started_ = false;
+}
+
+/**
+ * \brief Holds back the displacement of newly processed packets until the next move, a move is
+ * pending afterwards even without any displacement
+ * \param dx horizontal displacement (pixels)
+ * \param dy vertical displacement (pixels)
+ */
+void OutputCoalescer::add(const int& dx, const int& dy)
+{
+    held_x_ += dx;
+    held_y_ += dy;
+    holding_ = true;
+}
+
+/**
+ * \brief Returns whether a move is waiting to be released, either held back packets or a lead to take back
+ */
+bool OutputCoalescer::pending() const
+{
+    return holding_ || lead_x_ != 0 || lead_y_ != 0;
+}
+
+/**
+ * \brief Returns whether a move should be released now
+ * \param time current time (seconds)
+ */
+bool OutputCoalescer::due(const double& time) const
+{
+    if (!pending())
+    {
+        return false;
+    }
+    return period_ <= 0.0 || time >= next_flush_;
+}
+
+/**
+ * \brief Returns when the next move is due (seconds), only meaningful with a cadence while a move is pending
+ */
+double OutputCoalescer::next_flush() const
+{
+    return next_flush_;
+}
+
+/**
+ * \brief Releases the held displacement as a move
+ * \param time current time (seconds)
+ * \param dx horizontal displacement to move the cursor by (pixels)
+ * \param dy vertical displacement to move the cursor by (pixels)
+ * \return whether the cursor has to be moved
+ */
+bool OutputCoalescer::flush(const double& time, int& dx, int& dy)
+{
+    const bool predict = settings_.prediction && period_ > 0.0;
+
+    // The velocity is measured over each period, the first after a pause is measured over the
+    // whole pause and comes out low, so the lead builds up rather than overshooting a flick
+    const double elapsed = time - last_flush_;
+    if (predict && started_ && elapsed > 0.0)
+    {
+        velocity_x_ += kVelocitySmoothing * (held_x_ / elapsed - velocity_x_);
+        velocity_y_ += kVelocitySmoothing * (held_y_ / elapsed - velocity_y_);
+    }
+    else
+    {
+        velocity_x_ = 0.0;
+        velocity_y_ = 0.0;
+    }
+
+    // Displacement is held back half a period on average, the previous lead is taken back
+    int lead_x = 0;
+    int lead_y = 0;
+    if (predict)
+    {
+        lead_x = static_cast<int>(std::lround(velocity_x_ * 0.5 * period_));
+        lead_y = static_cast<int>(std::lround(velocity_y_ * 0.5 * period_));
+    }
+
+    dx = held_x_ + lead_x - lead_x_;
+    dy = held_y_ + lead_y - lead_y_;
+    lead_x_ = lead_x;
+    lead_y_ = lead_y;
+    held_x_ = 0;
+    held_y_ = 0;
+    holding_ = false;
+
+    // Moves keep to the cadence unless the pipeline fell behind it
+    last_flush_ = time;
+    started_ = true;
+    next_flush_ += period_;
+    if (next_flush_ <= time)
+    {
+        next_flush_ = time + period_;
+    }
+
+    return dx != 0 || dy != 0;
+}
+
+/**
+ * \brief Forgets the lead of the last move, for when the edge of the desktop stopped the cursor
+ * and there is nothing to take back
+ */
+void OutputCoalescer::drop_lead()
+{
+    lead_x_ = 0;
+    lead_y_ = 0;
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+/**
+ * \brief User adjustable parameters of the cursor output cadence
+ */
+struct OutputSettings
+{
+
+    // Cursor moves per second, 0 moves the cursor as soon as each burst of packets has been processed
+    double rate = 0.0;
+
+    // Whether moves lead the displacement by the time it was held back for
+    bool prediction = true;
+
+};
+
+/**
+ * \brief Accumulates cursor displacement and releases it as moves at a fixed cadence
+ *
+ * At high data rates most packets move the cursor by a pixel or less, and moving it for each of
+ * them costs the display server work it can never show. The coalescer holds the displacement back
+ * and releases it at most once per period, e.g. once per refresh of the monitor. Holding back
+ * delays the displacement by half a period on average, so with prediction each move also leads by
+ * the velocity measured over the recent periods times half a period. The lead is taken back from
+ * the following move, the cursor therefore never drifts from where the displacement put it by more
+ * than the current lead.
+ *
+ * Time is in seconds from any epoch, the live pipeline uses its monotonic clock and replays the
+ * sensor's timestamps.
+ */
+class OutputCoalescer
+{
+
+ public:
+
+    OutputCoalescer();
+
+    void set_settings(const OutputSettings& settings);
+    const OutputSettings& settings() const;
+
+    void reset();
+
+    void add(const int& dx, const int& dy);
+
+    bool pending() const;
+    bool due(const double& time) const;
+    double next_flush() const;
+
+    bool flush(const double& time, int& dx, int& dy);
+    void drop_lead();
+
+ private:
+
+    // Weight of the newest period in the velocity the lead is predicted from
+    static const double kVelocitySmoothing;
+
+    OutputSettings settings_;
+
+    // Seconds between moves, 0 without a cadence
+    double period_;
+
+    // Displacement held back since the last move (pixels)
+    int held_x_;
+    int held_y_;
+    bool holding_;
+
+    // Lead included in the last move (pixels)
+    int lead_x_;
+    int lead_y_;
+
+    // Velocity of the displacement (pixels per second)
+    double velocity_x_;
+    double velocity_y_;
+
+    double last_flush_;
+    double next_flush_;
+    bool started_;
+
+};
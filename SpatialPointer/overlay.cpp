@@ -1,10 +1,8 @@
 #include "overlay.h"
 #include "ui_overlay.h"
 #include <QTimer>
-#include <Windows.h>
-#pragma comment (lib,"User32.lib")
 
-Overlay::Overlay(QWidget *parent) : QWidget(parent), ui(new Ui::Overlay)
+Overlay::Overlay(CursorOutput* output, QWidget *parent) : QWidget(parent), ui(new Ui::Overlay), output_(output)
 {
     ui->setupUi(this);
 
@@ -51,7 +49,7 @@ void Overlay::slot_update()
     else
     {
         set_enabled(false, countdown_);
-        mouse_event(MOUSEEVENTF_LEFTDOWN | MOUSEEVENTF_LEFTUP, NULL, NULL, NULL, NULL);
+        output_->click();
 
     }
 }
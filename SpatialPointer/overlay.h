@@ -2,6 +2,7 @@
 #define OVERLAY_H
 
 #include <QWidget>
+#include "cursor_output.h"
 
 namespace Ui {
 class Overlay;
@@ -13,7 +14,7 @@ class Overlay : public QWidget
 
 public:
 
-    explicit Overlay(QWidget *parent = 0);
+    explicit Overlay(CursorOutput* output, QWidget *parent = 0);
     ~Overlay();
 
     void set_enabled(const bool& state, const int& countdown);
@@ -31,6 +32,9 @@ private:
 
     QTimer* tmr_update;
 
+    // Performs the click once the countdown completes
+    CursorOutput* output_;
+
     void set_countdown(const int& value);
 
     int countdown_;
@@ -1,5 +1,8 @@
 #include "phidget_spatial.h"
-#include "vector3.h"
+#include "monotonic_clock.h"
+#include "linear_algebra.h"
+#include <algorithm>
+#include <chrono>
 
 PhidgetSpatial* PhidgetSpatial::instance_ = nullptr;
 
@@ -30,6 +33,17 @@ bool PhidgetSpatial::initialize()
  */
 bool PhidgetSpatial::initialize(int data_rate, const int& timeout)
 {
+    // Packets are produced by an alternative source instead of the hardware
+    if (source_ != nullptr)
+    {
+        // The source's packets arrive at its own rate, whatever was asked of the hardware
+        source_->close();
+        attatched_ = source_->open(this);
+        const double rate = source_->sample_rate();
+        sample_rate_ = rate > 0.0 ? rate : 1000.0 / std::max(data_rate, 1);
+        return attatched_;
+    }
+
     if(handle != nullptr)
     {
         CPhidget_close((CPhidgetHandle)handle);
@@ -67,12 +81,74 @@ bool PhidgetSpatial::initialize(int data_rate, const int& timeout)
 
     // Set the data rate of the Phidget
     CPhidgetSpatial_setDataRate(handle, data_rate);
+    sample_rate_ = 1000.0 / data_rate;
 
     attatched_ = true;
 
     return true;
 }
 
+/**
+ * \brief Stops the hardware or the alternative source, no packets are delivered once this returns
+ */
+void PhidgetSpatial::close()
+{
+    if (source_ != nullptr)
+    {
+        source_->close();
+    }
+
+    if (handle != nullptr)
+    {
+        CPhidget_close(reinterpret_cast<CPhidgetHandle>(handle));
+        CPhidget_delete(reinterpret_cast<CPhidgetHandle>(handle));
+        handle = nullptr;
+    }
+
+    attatched_ = false;
+}
+
+/**
+ * \brief Replaces the phidget21 hardware with an alternative source of packets, takes effect on the next initialize
+ * \param source source of packets (nullptr = hardware)
+ */
+void PhidgetSpatial::set_source(SpatialSource* source)
+{
+    if (source_ != nullptr)
+    {
+        source_->close();
+        attatched_ = false;
+    }
+    source_ = source;
+}
+
+/**
+ * \brief Delivers packets from an alternative source through the same path as hardware packets
+ * \param data array of spatial event data
+ * \param packets number of packets within the data
+ */
+void PhidgetSpatial::inject_packets(CPhidgetSpatial_SpatialEventDataHandle* data, int packets)
+{
+    DataHandler(nullptr, this, data, packets);
+}
+
+/**
+ * \brief Called by an alternative source when it can no longer deliver packets
+ */
+void PhidgetSpatial::source_detatched()
+{
+    attatched_ = false;
+}
+
+/**
+ * \brief Records every subsequent packet with the given recorder
+ * \param recorder open recorder (nullptr = stop recording)
+ */
+void PhidgetSpatial::set_recorder(SessionRecorder* recorder)
+{
+    recorder_.store(recorder, std::memory_order_release);
+}
+
 /**
  * \brief Returns true if the Phidget is attatched
  */
@@ -89,33 +165,122 @@ int PhidgetSpatial::GetLastError() const
     return error_;
 }
 
+/**
+* \brief Returns the rate at which packets are reported (packets per second)
+*/
+double PhidgetSpatial::sample_rate() const
+{
+    return sample_rate_;
+}
+
 /**
 * \brief Returns the Phidget's acceleration data
 */
-Vector3<double> PhidgetSpatial::acceleration() const
+Vec3d PhidgetSpatial::acceleration() const
 {
-    return acceleration_;
+    return latest_sample_.load().acceleration;
 }
 
 /**
 * \brief Returns the Phidget's angular rate data
 */
-Vector3<double> PhidgetSpatial::angular_rate() const
+Vec3d PhidgetSpatial::angular_rate() const
 {
-    return angular_rate_;
+    return latest_sample_.load().angular_rate;
 }
 
 /**
 * \brief Returns the Phidget's magnetic field data
 */
-Vector3<double> PhidgetSpatial::magnetic_field() const
+Vec3d PhidgetSpatial::magnetic_field() const
+{
+    return latest_sample_.load().magnetic_field;
+}
+
+/**
+* \brief Returns the most recent packet, all values are guaranteed to come from the same packet
+*/
+SpatialSample PhidgetSpatial::latest_sample() const
+{
+    return latest_sample_.load();
+}
+
+/**
+* \brief Moves the oldest unprocessed packets into a block until it is full, returns false if none were pending
+* \param block receives the packets, it is cleared first
+* \note Must only be called from a single consumer thread
+*
+* Packets are queued whole and only split into channels here. A packet is pushed in one step, so
+* the callback never waits for or exposes a partly filled block, a burst's packets are available to
+* the consumer as soon as each arrives, and a full queue drops single packets rather than whole
+* blocks. The transpose is a few copies per packet on the consumer's side, once per packet either way.
+*/
+bool PhidgetSpatial::pop_samples(SampleBlock& block)
+{
+    block.clear();
+
+    SpatialSample sample;
+    while (!block.full() && samples_.pop(sample))
+        block.push(sample);
+
+    return block.count > 0;
+}
+
+/**
+* \brief Discards every unprocessed packet and resets the dropped packet count
+* \note Must only be called from the consumer thread
+*/
+void PhidgetSpatial::clear_samples()
+{
+    samples_.clear();
+}
+
+/**
+* \brief Blocks until at least one packet is waiting to be processed, returns false on timeout
+* \param timeout maximum time to wait (milliseconds)
+* \note Must only be called from the consumer thread
+*/
+bool PhidgetSpatial::wait_for_samples(const int& timeout)
+{
+    std::unique_lock<std::mutex> lock(samples_mutex_);
+    consumer_waiting_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const bool available = samples_available_.wait_for(lock, std::chrono::milliseconds(timeout), [this] { return samples_.size() > 0; });
+    consumer_waiting_.store(false, std::memory_order_relaxed);
+    return available;
+}
+
+/**
+* \brief Returns the number of packets waiting to be processed
+*/
+std::size_t PhidgetSpatial::pending_samples() const
+{
+    return samples_.size();
+}
+
+/**
+* \brief Returns the maximum number of packets that can wait to be processed
+*/
+std::size_t PhidgetSpatial::sample_capacity() const
 {
-    return magnetic_field_;
+    return samples_.capacity();
+}
+
+/**
+* \brief Returns the number of packets dropped because the consumer fell behind
+*/
+std::uint64_t PhidgetSpatial::dropped_samples() const
+{
+    return samples_.overflow_count();
 }
 
 PhidgetSpatial::PhidgetSpatial()
 {
     handle = nullptr;
+    source_ = nullptr;
+    recorder_ = nullptr;
+    consumer_waiting_ = false;
+    sample_rate_ = 1000.0 / kDataRateDefault;
     attatched_ = false;
 }
 
@@ -154,7 +319,7 @@ int PhidgetSpatial::ErrorHandler(CPhidgetHandle handle, void* user_ptr, int erro
 }
 
 /**
- * \brief Called when the Phidget encoutners an error
+ * \brief Called when the Phidget reports new data, every packet is queued for the consumer
  * \param handle phidget handle
  * \param user_ptr optional parameter for reinterpret casting
  * \param data array of spatial event data
@@ -163,11 +328,40 @@ int PhidgetSpatial::ErrorHandler(CPhidgetHandle handle, void* user_ptr, int erro
 int PhidgetSpatial::DataHandler(CPhidgetSpatialHandle handle, void* user_ptr, CPhidgetSpatial_SpatialEventDataHandle* data, int packets)
 {
     auto phidget_spatial = static_cast<PhidgetSpatial*>(user_ptr);
+    auto recorder = phidget_spatial->recorder_.load(std::memory_order_acquire);
+    SpatialSample sample;
+    sample.ingest_time = monotonic_ns();
     for (int i = 0; i < packets; ++i)
     {
-        phidget_spatial->acceleration_ = Vector3<double>(data[i]->acceleration[0], data[i]->acceleration[1], data[i]->acceleration[2]);
-        phidget_spatial->angular_rate_ = Vector3<double>(data[i]->angularRate[0], data[i]->angularRate[1], data[i]->angularRate[2]);
-        phidget_spatial->magnetic_field_ = Vector3<double>(data[i]->magneticField[0], data[i]->magneticField[1], data[i]->magneticField[2]);
+        sample.acceleration = Vec3d(data[i]->acceleration[0], data[i]->acceleration[1], data[i]->acceleration[2]);
+        sample.angular_rate = Vec3d(data[i]->angularRate[0], data[i]->angularRate[1], data[i]->angularRate[2]);
+        sample.magnetic_field = Vec3d(data[i]->magneticField[0], data[i]->magneticField[1], data[i]->magneticField[2]);
+        sample.timestamp = data[i]->timestamp.seconds + data[i]->timestamp.microseconds / 1000000.0;
+
+        // A full buffer drops the packet and counts it, the callback thread must never block
+        phidget_spatial->samples_.push(sample);
+
+        if (recorder != nullptr)
+        {
+            recorder->record(sample);
+        }
+    }
+
+    // Publish the newest packet as a whole so readers never observe a mix of two packets
+    if (packets > 0)
+    {
+        phidget_spatial->latest_sample_.store(sample);
+
+        // Either the consumer sees the push before it sleeps or the callback sees it waiting, a busy
+        // consumer is left alone. Taking the lock orders the wake up after the consumer has gone to sleep.
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (phidget_spatial->consumer_waiting_.load(std::memory_order_relaxed))
+        {
+            {
+                std::lock_guard<std::mutex> lock(phidget_spatial->samples_mutex_);
+            }
+            phidget_spatial->samples_available_.notify_one();
+        }
     }
     return 0;
 }
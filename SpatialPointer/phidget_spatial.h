@@ -1,6 +1,16 @@
 #pragma once
 #include <phidget21.h>
-#include "vector3.h"
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include "linear_algebra.h"
+#include "sample_block.h"
+#include "seq_lock.h"
+#include "session_recorder.h"
+#include "spatial_sample.h"
+#include "spatial_source.h"
+#include "spsc_ring_buffer.h"
 
 class PhidgetSpatial
 {
@@ -11,17 +21,40 @@ class PhidgetSpatial
 
     bool initialize();
     bool initialize(int data_rate, const int& timeout);
+    void close();
+
+    void set_source(SpatialSource* source);
+
+    void inject_packets(CPhidgetSpatial_SpatialEventDataHandle* data, int packets);
+    void source_detatched();
+
+    void set_recorder(SessionRecorder* recorder);
 
     bool attatched() const;
 
     int GetLastError() const;
 
-    Vector3<double> acceleration() const;
-    Vector3<double> angular_rate() const;
-    Vector3<double> magnetic_field() const;
+    double sample_rate() const;
+
+    Vec3d acceleration() const;
+    Vec3d angular_rate() const;
+    Vec3d magnetic_field() const;
+
+    SpatialSample latest_sample() const;
+
+    bool pop_samples(SampleBlock& block);
+    void clear_samples();
+
+    bool wait_for_samples(const int& timeout);
+
+    std::size_t pending_samples() const;
+    std::size_t sample_capacity() const;
+    std::uint64_t dropped_samples() const;
 
  private:
 
+    static const std::size_t kSampleCapacity = 1024;
+
     const int kDataRateDefault = 8;
     const int kTimeoutDefault = 0;
 
@@ -32,11 +65,25 @@ class PhidgetSpatial
 
     CPhidgetSpatialHandle handle;
 
-    Vector3<double> acceleration_;
-    Vector3<double> angular_rate_;
-    Vector3<double> magnetic_field_;
+    SpatialSource* source_;
+
+    std::atomic<SessionRecorder*> recorder_;
+
+    SeqLock<SpatialSample> latest_sample_;
+
+    // Whole packets, split into channels by pop_samples
+    SpscRingBuffer<SpatialSample, kSampleCapacity> samples_;
+
+    // Wakes the consumer when new packets are queued, the callback only takes the lock while the
+    // consumer is waiting
+    std::mutex samples_mutex_;
+    std::condition_variable samples_available_;
+    std::atomic<bool> consumer_waiting_;
+
+    // Packets per second, set by initialize from the hardware's data rate or the source
+    std::atomic<double> sample_rate_;
 
-    bool attatched_;
+    std::atomic<bool> attatched_;
     int error_;
 
     PhidgetSpatial();
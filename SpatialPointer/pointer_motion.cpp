@@ -0,0 +1,374 @@
+#include "pointer_motion.h"
+#include "block_kernels.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+PointerMotion::PointerMotion()
+{
+    reset();
+}
+
+/**
+ * \brief Sets the parameters used for subsequent packets
+ * \param settings new parameters
+ */
+void PointerMotion::set_settings(const PointerSettings& settings)
+{
+    // Prediction starts from what the next packet measures rather than a stale state
+    if (settings.look_ahead > 0.0 && !prediction())
+    {
+        prediction_x_.reset();
+        prediction_y_.reset();
+    }
+
+    settings_ = settings;
+    ballistics_.set_settings(settings.ballistics);
+
+    // Keep the deadzone's inner edge between its limits for the new tolerance
+    deadzone_ = std::min(std::max(deadzone_, settings_.tolerance * kDeadzoneRelease), static_cast<double>(settings_.tolerance));
+
+    // Hand out whatever the smoothing was holding back once it is switched off
+    if (!smoothing())
+    {
+        displacement_x_ += smoothing_x_.flush();
+        displacement_y_ += smoothing_y_.flush();
+    }
+}
+
+/**
+ * \brief Returns the parameters currently in use
+ */
+const PointerSettings& PointerMotion::settings() const
+{
+    return settings_;
+}
+
+/**
+ * \brief Discards any pending displacement and the time base, the next packet restarts integration
+ */
+void PointerMotion::reset()
+{
+    last_timestamp_ = 0.0;
+    has_timestamp_ = false;
+    displacement_x_ = 0.0;
+    displacement_y_ = 0.0;
+    deadzone_ = settings_.tolerance;
+    deadzone_interval_ = 0.0;
+    deadzone_step_ = 0.0;
+    smoothing_x_.reset();
+    smoothing_y_.reset();
+    prediction_x_.reset();
+    prediction_y_.reset();
+}
+
+/**
+ * \brief Integrates a packet's angular rate over the time elapsed since the previous packet
+ * \param sample packet reported by the PhidgetSpatial
+ */
+void PointerMotion::integrate(const SpatialSample& sample)
+{
+    const double dt = sample.timestamp - last_timestamp_;
+    const bool continuous = has_timestamp_ && dt > 0.0 && dt <= kMaxSampleInterval;
+
+    last_timestamp_ = sample.timestamp;
+    has_timestamp_ = true;
+
+    double angular_x = sample.angular_rate.z;
+    double angular_y = sample.angular_rate.x;
+    if (prediction())
+    {
+        prediction_x_.update(angular_x, continuous ? dt : 0.0);
+        prediction_y_.update(angular_y, continuous ? dt : 0.0);
+        angular_x = prediction_x_.predict(settings_.look_ahead);
+        angular_y = prediction_y_.predict(settings_.look_ahead);
+    }
+
+    // The first packet of a stream (or after a gap) only establishes the time base
+    if (!continuous)
+    {
+        return;
+    }
+
+    double rate_x = axis_velocity(angular_x, settings_.horizontal);
+    double rate_y = axis_velocity(angular_y, settings_.vertical);
+    if (settings_.tolerance > 0)
+    {
+        const double scale = deadzone_scale(std::sqrt(rate_x * rate_x + rate_y * rate_y), dt);
+        rate_x *= scale;
+        rate_y *= scale;
+    }
+
+    double gain = settings_.speed * kPixelsPerDegree;
+    if (ballistics_.enabled())
+    {
+        gain *= ballistics_.gain(static_cast<float>(std::sqrt(rate_x * rate_x + rate_y * rate_y)));
+    }
+    const double velocity_x = rate_x * gain;
+    const double velocity_y = rate_y * gain;
+
+    if (smoothing())
+    {
+        displacement_x_ += smoothing_x_.step(velocity_x, dt, settings_.min_cutoff, settings_.beta);
+        displacement_y_ += smoothing_y_.step(velocity_y, dt, settings_.min_cutoff, settings_.beta);
+    }
+    else
+    {
+        displacement_x_ += velocity_x * dt;
+        displacement_y_ += velocity_y * dt;
+    }
+}
+
+/**
+ * \brief Integrates the angular rate of a block of packets, each over the time elapsed since the packet before it
+ * \param block packets reported by the PhidgetSpatial
+ */
+void PointerMotion::integrate(const SampleBlock& block)
+{
+    if (block.count == 0)
+    {
+        return;
+    }
+
+    // Zero intervals mark the first packet of a stream (or after a gap), which only establishes the time base
+    float intervals[SampleBlock::kCapacity];
+    block_intervals(block.timestamp, block.count, has_timestamp_ ? last_timestamp_ : std::numeric_limits<double>::quiet_NaN(), kMaxSampleInterval, intervals);
+
+    last_timestamp_ = block.timestamp[block.count - 1];
+    has_timestamp_ = true;
+
+    // A disabled axis is zeroed but still passes through its filter so that it comes to rest smoothly
+    float rates_x[SampleBlock::kCapacity];
+    float rates_y[SampleBlock::kCapacity];
+    if (settings_.horizontal)
+    {
+        std::copy(block.channel(SampleBlock::kAngularRateZ), block.channel(SampleBlock::kAngularRateZ) + block.count, rates_x);
+    }
+    else
+    {
+        std::fill(rates_x, rates_x + block.count, 0.0f);
+    }
+    if (settings_.vertical)
+    {
+        std::copy(block.channel(SampleBlock::kAngularRateX), block.channel(SampleBlock::kAngularRateX) + block.count, rates_y);
+    }
+    else
+    {
+        std::fill(rates_y, rates_y + block.count, 0.0f);
+    }
+
+    if (prediction())
+    {
+        predict(rates_x, rates_y, intervals, block.count);
+    }
+
+    if (settings_.tolerance > 0)
+    {
+        apply_deadzone(rates_x, rates_y, intervals, block.count);
+    }
+
+    if (ballistics_.enabled())
+    {
+        accelerate(rates_x, rates_y, block.count);
+    }
+
+    displacement_x_ += axis_displacement(rates_x, intervals, block.count, settings_.horizontal, smoothing_x_);
+    displacement_y_ += axis_displacement(rates_y, intervals, block.count, settings_.vertical, smoothing_y_);
+}
+
+/**
+ * \brief Returns the whole pixels accumulated since the last call, the fractional remainder is kept
+ * \param x receives the horizontal displacement
+ * \param y receives the vertical displacement
+ */
+void PointerMotion::take_pixels(int& x, int& y)
+{
+    x = take_whole_pixels(displacement_x_);
+    y = take_whole_pixels(displacement_y_);
+}
+
+/**
+ * \brief Returns the horizontal sub-pixel displacement carried over to the next move
+ */
+double PointerMotion::residual_x() const
+{
+    return displacement_x_;
+}
+
+/**
+ * \brief Returns the vertical sub-pixel displacement carried over to the next move
+ */
+double PointerMotion::residual_y() const
+{
+    return displacement_y_;
+}
+
+/**
+ * \brief Returns the angular rate of an axis once the inversion has been applied
+ * \param angular_rate angular rate of the axis (degrees per second)
+ * \param enabled whether movement along the axis is enabled
+ */
+double PointerMotion::axis_velocity(const double& angular_rate, const bool& enabled) const
+{
+    if (!enabled)
+    {
+        return 0.0;
+    }
+    return settings_.invert ? -angular_rate : angular_rate;
+}
+
+/**
+ * \brief Returns the factor the deadzone scales a packet's angular rate by, and moves the deadzone's inner edge
+ * \param speed angular speed across both axes (degrees per second)
+ * \param dt time elapsed since the previous packet (seconds)
+ */
+double PointerMotion::deadzone_scale(const double& speed, const double& dt)
+{
+    const double knee = kDeadzoneKnee * settings_.tolerance;
+
+    double scale = 1.0;
+    if (speed <= deadzone_)
+    {
+        scale = 0.0;
+    }
+    else if (speed < knee)
+    {
+        // Cubic Hermite from no movement with zero slope at the inner edge to the unmodified
+        // speed with unit slope at the knee, which rises monotonically in between
+        const double width = knee - deadzone_;
+        const double t = (speed - deadzone_) / width;
+        const double t2 = t * t;
+        const double t3 = t2 * t;
+        scale = (knee * (3.0 * t2 - 2.0 * t3) + width * (t3 - t2)) / speed;
+    }
+
+    // The inner edge shrinks while moving and grows back at rest
+    if (dt != deadzone_interval_)
+    {
+        deadzone_interval_ = dt;
+        deadzone_step_ = 1.0 - std::exp(-dt / kDeadzoneTimeConstant);
+    }
+    const double target = speed > deadzone_ ? settings_.tolerance * kDeadzoneRelease : settings_.tolerance;
+    deadzone_ += (target - deadzone_) * deadzone_step_;
+
+    return scale;
+}
+
+/**
+ * \brief Replaces the angular rate of both axes of a block with the rate extrapolated by the look-ahead
+ * \param rates_x horizontal angular rate for each packet (degrees per second), replaced in place
+ * \param rates_y vertical angular rate for each packet (degrees per second), replaced in place
+ * \param intervals time elapsed since the previous packet for each packet (seconds), zero restarts the filters
+ * \param count number of packets
+ */
+void PointerMotion::predict(float* rates_x, float* rates_y, const float* intervals, const std::size_t& count)
+{
+    // The filters are recursive, they run a packet at a time
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        prediction_x_.update(rates_x[i], intervals[i]);
+        prediction_y_.update(rates_y[i], intervals[i]);
+        rates_x[i] = static_cast<float>(prediction_x_.predict(settings_.look_ahead));
+        rates_y[i] = static_cast<float>(prediction_y_.predict(settings_.look_ahead));
+    }
+}
+
+/**
+ * \brief Applies the deadzone to the angular rate of both axes of a block
+ * \param rates_x horizontal angular rate for each packet (degrees per second), scaled in place
+ * \param rates_y vertical angular rate for each packet (degrees per second), scaled in place
+ * \param intervals time elapsed since the previous packet for each packet (seconds)
+ * \param count number of packets
+ */
+void PointerMotion::apply_deadzone(float* rates_x, float* rates_y, const float* intervals, const std::size_t& count)
+{
+    // The inner edge depends on the packets before, the deadzone runs a packet at a time. Packets
+    // that only establish the time base move nothing and are skipped
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (intervals[i] > 0.0f)
+        {
+            const float scale = static_cast<float>(deadzone_scale(std::sqrt(rates_x[i] * rates_x[i] + rates_y[i] * rates_y[i]), intervals[i]));
+            rates_x[i] *= scale;
+            rates_y[i] *= scale;
+        }
+    }
+}
+
+/**
+ * \brief Returns the displacement (pixels) of an axis over a block once the inversion and smoothing have been applied
+ * \param rates angular rate of the axis for each packet once the deadzone and acceleration have been applied (degrees per second)
+ * \param intervals time elapsed since the previous packet for each packet (seconds)
+ * \param count number of packets
+ * \param enabled whether movement along the axis is enabled
+ * \param filter smoothing filter of the axis
+ */
+double PointerMotion::axis_displacement(const float* rates, const float* intervals, const std::size_t& count, const bool& enabled, OneEuroFilter& filter)
+{
+    const double gain = settings_.invert ? -settings_.speed * kPixelsPerDegree : settings_.speed * kPixelsPerDegree;
+    if (!smoothing())
+    {
+        return enabled ? block_dot(rates, intervals, count) * gain : 0.0;
+    }
+
+    // The filter is recursive, it runs a packet at a time
+    double displacement = 0.0;
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        if (intervals[i] > 0.0f)
+        {
+            displacement += filter.step(rates[i] * gain, intervals[i], settings_.min_cutoff, settings_.beta);
+        }
+    }
+    return displacement;
+}
+
+/**
+ * \brief Scales the angular rate of both axes by the acceleration curve's gain at each packet's angular speed
+ * \param rates_x horizontal angular rate for each packet (degrees per second), scaled in place
+ * \param rates_y vertical angular rate for each packet (degrees per second), scaled in place
+ * \param count number of packets
+ */
+void PointerMotion::accelerate(float* rates_x, float* rates_y, const std::size_t& count) const
+{
+    float gains[SampleBlock::kCapacity];
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        gains[i] = std::sqrt(rates_x[i] * rates_x[i] + rates_y[i] * rates_y[i]);
+    }
+
+    ballistics_.gains(gains, count, gains);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        rates_x[i] *= gains[i];
+        rates_y[i] *= gains[i];
+    }
+}
+
+/**
+ * \brief Returns whether the cursor is smoothed
+ */
+bool PointerMotion::smoothing() const
+{
+    return settings_.min_cutoff > 0.0;
+}
+
+/**
+ * \brief Returns whether the angular rate is extrapolated ahead
+ */
+bool PointerMotion::prediction() const
+{
+    return settings_.look_ahead > 0.0;
+}
+
+/**
+ * \brief Removes and returns the whole pixels of a displacement, leaving the fraction behind
+ * \param displacement displacement (pixels)
+ */
+int PointerMotion::take_whole_pixels(double& displacement)
+{
+    const double whole = std::trunc(displacement);
+    displacement -= whole;
+    return static_cast<int>(whole);
+}
@@ -0,0 +1,132 @@
+#pragma once
+#include "ballistics_curve.h"
+#include "one_euro_filter.h"
+#include "rate_kalman.h"
+#include "sample_block.h"
+#include "spatial_sample.h"
+
+/**
+ * \brief User adjustable parameters of the pointer motion
+ */
+struct PointerSettings
+{
+
+    int tolerance = 0;
+    int speed = 0;
+
+    bool horizontal = true;
+    bool vertical = true;
+    bool invert = false;
+
+    // Speed dependent smoothing of the cursor (hertz, hertz per pixel per second), disabled while
+    // min_cutoff is zero
+    double min_cutoff = 0.0;
+    double beta = 0.0;
+
+    // Acceleration curve scaling the speed with the head's angular speed
+    BallisticsSettings ballistics;
+
+    // Time (seconds) the angular rate is extrapolated ahead to hide the latency between the head
+    // moving and the cursor following, disabled while zero
+    double look_ahead = 0.0;
+
+};
+
+/**
+ * \brief Converts the PhidgetSpatial's angular rate into cursor displacement
+ *
+ * Every packet is integrated over the time elapsed since the previous packet according to the
+ * Phidget's hardware timestamps, so the distance travelled does not depend on how often or how
+ * regularly the displacement is collected. Only whole pixels are handed out, the fractional
+ * remainder of each axis is carried over so that slow movement is never discarded. A block of
+ * packets is integrated a channel at a time, which gives the same displacement as integrating its
+ * packets one by one.
+ *
+ * The deadzone is radial, it acts on the angular speed across both axes so diagonal movement is
+ * not snapped to an axis. Rather than cutting in at the tolerance, the speed is eased in along a
+ * soft knee that reaches the unmodified speed at twice the tolerance. The deadzone has hysteresis:
+ * once the head moves out of it, its inner edge shrinks to half the tolerance so that slow,
+ * deliberate movement carries on, and grows back once the head comes to rest. The edge moves
+ * gradually so the cursor never jumps as it does.
+ *
+ * With a look-ahead, each axis's angular rate is first tracked by a RateKalman and replaced by
+ * the rate extrapolated that far ahead, which moves the cursor to where the head will be pointing.
+ *
+ * When an acceleration curve is set, the gain of each packet is looked up from
+ * its angular speed across both axes, so the cursor keeps its direction. When smoothing is enabled
+ * each axis is passed through a OneEuroFilter a packet at a time.
+ */
+class PointerMotion
+{
+
+ public:
+
+    PointerMotion();
+
+    void set_settings(const PointerSettings& settings);
+    const PointerSettings& settings() const;
+
+    void reset();
+
+    void integrate(const SpatialSample& sample);
+    void integrate(const SampleBlock& block);
+
+    void take_pixels(int& x, int& y);
+
+    double residual_x() const;
+    double residual_y() const;
+
+ private:
+
+    // Cursor travel (pixels) per degree of rotation per unit of speed, chosen so that the gain
+    // matches the original implementation which applied rate * speed once every 10 ms
+    const double kPixelsPerDegree = 100.0;
+
+    // Gaps between packets longer than this (seconds) are treated as a restart of the stream
+    const double kMaxSampleInterval = 0.25;
+
+    // Multiple of the tolerance at which the deadzone's knee reaches the unmodified speed, and the
+    // fraction of the tolerance the deadzone's inner edge shrinks to while the head is moving
+    const double kDeadzoneKnee = 2.0;
+    const double kDeadzoneRelease = 0.5;
+
+    // Time constant (seconds) of the deadzone's inner edge shrinking and growing back
+    const double kDeadzoneTimeConstant = 0.1;
+
+    PointerSettings settings_;
+
+    double last_timestamp_;
+    bool has_timestamp_;
+
+    // Displacement (pixels) not yet handed out, including the sub-pixel remainder
+    double displacement_x_;
+    double displacement_y_;
+
+    // Inner edge of the deadzone (degrees per second), and the proportion of the way to its target
+    // it moves over the last packet interval seen (seconds), packets nearly always share an interval
+    double deadzone_;
+    double deadzone_interval_;
+    double deadzone_step_;
+
+    OneEuroFilter smoothing_x_;
+    OneEuroFilter smoothing_y_;
+
+    BallisticsCurve ballistics_;
+
+    RateKalman prediction_x_;
+    RateKalman prediction_y_;
+
+    bool smoothing() const;
+    bool prediction() const;
+
+    double axis_velocity(const double& angular_rate, const bool& enabled) const;
+    double deadzone_scale(const double& speed, const double& dt);
+    void predict(float* rates_x, float* rates_y, const float* intervals, const std::size_t& count);
+    void apply_deadzone(float* rates_x, float* rates_y, const float* intervals, const std::size_t& count);
+    double axis_displacement(const float* rates, const float* intervals, const std::size_t& count, const bool& enabled, OneEuroFilter& filter);
+
+    void accelerate(float* rates_x, float* rates_y, const std::size_t& count) const;
+
+    static int take_whole_pixels(double& displacement);
+
+};
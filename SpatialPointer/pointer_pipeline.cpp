@@ -0,0 +1,469 @@
+#include "pointer_pipeline.h"
+#include "phidget_spatial.h"
+#include "monotonic_clock.h"
+#include <QCursor>
+#include <QTimer>
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Initialize
+ * @param spatial source of the packets
+ * @param output destination of the cursor movement
+ * @param parent parent object
+ */
+PointerPipeline::PointerPipeline(PhidgetSpatial* spatial, CursorOutput* output, QObject *parent) : QThread(parent), spatial_(spatial), output_(output)
+{
+    // The pipeline object lives on the GUI thread, so does the timer reading the cursor for the pipeline thread
+    cursor_timer_ = new QTimer(this);
+    cursor_timer_->setInterval(kCursorReadInterval);
+    connect(cursor_timer_, SIGNAL(timeout()), this, SLOT(read_cursor()));
+}
+
+/**
+ * @brief Clean up
+ */
+PointerPipeline::~PointerPipeline()
+{
+    stop();
+}
+
+/**
+ * @brief Sets the motion parameters, takes effect from the next packet
+ * @param settings new parameters
+ */
+void PointerPipeline::set_settings(const PointerSettings& settings)
+{
+    settings_.store(settings);
+}
+
+/**
+ * @brief Sets the dwell click parameters, takes effect from the next packet
+ * @param settings new parameters
+ */
+void PointerPipeline::set_dwell_settings(const DwellSettings& settings)
+{
+    dwell_settings_.store(settings);
+}
+
+/**
+ * @brief Sets the filter bank parameters, takes effect from the next packet
+ * @param settings new parameters, the sample rate is taken from the PhidgetSpatial
+ */
+void PointerPipeline::set_filter_settings(const FilterSettings& settings)
+{
+    filter_settings_.store(settings);
+}
+
+/**
+ * @brief Sets the orientation fusion parameters, takes effect from the next packet
+ * @param settings new parameters
+ */
+void PointerPipeline::set_orientation_settings(const OrientationSettings& settings)
+{
+    orientation_settings_.store(settings);
+}
+
+/**
+ * @brief Sets the absolute pointing parameters, takes effect from the next packet
+ * @param settings new parameters
+ */
+void PointerPipeline::set_absolute_settings(const AbsoluteSettings& settings)
+{
+    absolute_settings_.store(settings);
+}
+
+/**
+ * @brief Sets the arrangement of the monitors the cursor is kept on, takes effect from the next packet
+ * @param layout new arrangement
+ */
+void PointerPipeline::set_desktop_layout(const DesktopLayout& layout)
+{
+    desktop_layout_.store(layout);
+}
+
+/**
+ * @brief Sets the cadence of the cursor moves, takes effect from the next packet
+ * @param settings new parameters
+ */
+void PointerPipeline::set_output_settings(const OutputSettings& settings)
+{
+    output_settings_.store(settings);
+}
+
+/**
+ * @brief Returns the most recently published pipeline state
+ */
+PipelineStatus PointerPipeline::status() const
+{
+    return status_.load();
+}
+
+/**
+ * @brief Returns the time packets spend queued before the pipeline processes them
+ */
+const LatencyHistogram& PointerPipeline::queue_latency() const
+{
+    return queue_latency_;
+}
+
+/**
+ * @brief Returns the time from the pipeline picking up a burst of packets to the output placing the resulting cursor
+ * move, including the time the move was held back to keep to the output cadence
+ */
+const LatencyHistogram& PointerPipeline::processing_latency() const
+{
+    return processing_latency_;
+}
+
+/**
+ * @brief Returns the time from a packet being received from the Phidget to the output placing the resulting cursor move
+ */
+const LatencyHistogram& PointerPipeline::end_to_end_latency() const
+{
+    return end_to_end_latency_;
+}
+
+/**
+ * @brief Returns the time spent filtering each packet
+ */
+const LatencyHistogram& PointerPipeline::filter_cost() const
+{
+    return filter_cost_;
+}
+
+/**
+ * @brief Returns the time spent fusing each packet into the orientation estimate
+ */
+const LatencyHistogram& PointerPipeline::fusion_cost() const
+{
+    return fusion_cost_;
+}
+
+/**
+ * @brief Clears every latency histogram
+ */
+void PointerPipeline::reset_latency()
+{
+    queue_latency_.reset();
+    processing_latency_.reset();
+    end_to_end_latency_.reset();
+    filter_cost_.reset();
+    fusion_cost_.reset();
+}
+
+/**
+ * @brief Starts the pipeline thread from wherever the cursor is now
+ * @param priority priority of the pipeline thread
+ */
+void PointerPipeline::start(QThread::Priority priority)
+{
+    read_cursor();
+
+    // A relative output's cursor is never read back, so only an absolute one needs the real cursor kept up to date
+    if(!output_->relative())
+        cursor_timer_->start();
+
+    QThread::start(priority);
+}
+
+/**
+ * @brief Stops the pipeline and waits for the thread to finish
+ */
+void PointerPipeline::stop()
+{
+    cursor_timer_->stop();
+    requestInterruption();
+    wait();
+}
+
+/**
+ * @brief Publishes the real cursor's position to the pipeline thread, runs on the GUI thread
+ */
+void PointerPipeline::read_cursor()
+{
+    CursorReading reading;
+    reading.position = QCursor::pos();
+    reading.time = monotonic_ns();
+    real_cursor_.store(reading);
+}
+
+/**
+ * @brief Pipeline thread, processes packets as soon as they arrive and moves the cursor at the output cadence
+ */
+void PointerPipeline::run()
+{
+    PointerSettings settings;
+    PointerMotion motion;
+    DwellDetector dwell;
+    GyroBiasEstimator bias;
+    FilterBank filter;
+    OrientationFilter orientation;
+    AbsolutePointer absolute;
+    bool absolute_enabled = false;
+
+    // The cursor's position is tracked locally rather than asking the display server for it on
+    // every move, the real cursor is only read back now and then to notice the mouse moving it
+    CursorModel cursor;
+    cursor.set_layout(desktop_layout_.load());
+    QPoint position = real_cursor_.load().position;
+    cursor.sync(position.x(), position.y());
+    std::int64_t move_time = monotonic_ns();
+    std::int64_t resync_time = move_time;
+    long long resyncs = 0;
+    const bool relative = output_->relative();
+    bool dwell_started = false;
+    bool countdown = false;
+
+    // Displacement is held back between moves when the output has a cadence
+    OutputCoalescer coalescer;
+    std::int64_t ingest_times[kMaxBurst];
+    int held = 0;
+    std::int64_t hold_time = move_time;
+    long long samples = 0;
+    long long moves = 0;
+
+    // Packets of the moves the output has not placed yet, their latency ends when the cursor is placed
+    std::int64_t unlanded_times[kMaxBurst];
+    int unlanded = 0;
+    std::int64_t unlanded_hold_time = move_time;
+    bool moving = false;
+
+    // Records the latencies of the moves once the output reports them placed
+    const auto record_landed = [&]()
+    {
+        std::int64_t landed_time;
+        if(!moving || !output_->landed(landed_time))
+            return;
+
+        moving = false;
+        move_time = std::max(move_time, landed_time);
+        processing_latency_.record(landed_time - unlanded_hold_time);
+        for(int i = 0; i < unlanded; ++i)
+            end_to_end_latency_.record(landed_time - unlanded_times[i]);
+        unlanded = 0;
+    };
+
+    // Releases the held displacement, returns whether the cursor was moved
+    const auto release = [&](const std::int64_t& now) -> bool
+    {
+        int displacement_x;
+        int displacement_y;
+        coalescer.flush(now * 1.0e-9, displacement_x, displacement_y);
+
+        // In absolute mode the cursor is moved straight to where the head is pointing
+        if(absolute_enabled && absolute.has_position())
+        {
+            displacement_x = settings.horizontal ? absolute.x() - cursor.x() : 0;
+            displacement_y = settings.vertical ? absolute.y() - cursor.y() : 0;
+        }
+
+        const int packets = held;
+        held = 0;
+        if(displacement_x == 0 && displacement_y == 0)
+            return false;
+
+        // A lead the edge of the desktop swallowed must not be taken back from the next move
+        const int previous_x = cursor.x();
+        const int previous_y = cursor.y();
+        cursor.move(displacement_x, displacement_y);
+        if(cursor.x() - previous_x != displacement_x || cursor.y() - previous_y != displacement_y)
+            coalescer.drop_lead();
+
+        position = QPoint(cursor.x(), cursor.y());
+        output_->move(displacement_x, displacement_y, position.x(), position.y());
+        ++moves;
+        move_time = monotonic_ns();
+
+        if(!moving)
+            unlanded_hold_time = hold_time;
+        moving = true;
+        for(int i = 0; i < packets && unlanded < kMaxBurst; ++i)
+            unlanded_times[unlanded++] = ingest_times[i];
+        record_landed();
+
+        // The GUI thread only follows the cursor while the overlay is counting down beside it
+        if(countdown)
+            emit cursor_moved(position);
+        return true;
+    };
+
+    // Discard packets that arrived while the pipeline was stopped
+    spatial_->clear_samples();
+
+    while(!isInterruptionRequested())
+    {
+        // Phidget Spatial was detatched, stop processing
+        if(!spatial_->attatched())
+        {
+            emit detached();
+            return;
+        }
+
+        // With a cadence the thread sleeps no longer than until the next move is due
+        int timeout = kWaitTimeout;
+        if(coalescer.settings().rate > 0.0 && coalescer.pending())
+        {
+            const double remaining = coalescer.next_flush() - monotonic_ns() * 1.0e-9;
+            timeout = std::min(kWaitTimeout, std::max(0, static_cast<int>(std::ceil(remaining * 1000.0))));
+        }
+
+        const bool available = spatial_->wait_for_samples(timeout);
+        record_landed();
+        if(!available)
+        {
+            const std::int64_t now = monotonic_ns();
+            if(coalescer.due(now * 1.0e-9))
+                release(now);
+            continue;
+        }
+
+        const std::int64_t process_time = monotonic_ns();
+
+        settings = settings_.load();
+        motion.set_settings(settings);
+        dwell.set_settings(dwell_settings_.load());
+        coalescer.set_settings(output_settings_.load());
+
+        // Filters are designed for the rate the packets are reported at, the hardware's or the source's
+        FilterSettings filter_settings = filter_settings_.load();
+        filter_settings.sample_rate = spatial_->sample_rate();
+        filter.set_settings(filter_settings);
+
+        orientation.set_settings(orientation_settings_.load());
+
+        // Whatever the head is pointing at when absolute pointing is switched on becomes the centre
+        const AbsoluteSettings absolute_settings = absolute_settings_.load();
+        if(absolute_settings.enabled != absolute_enabled)
+        {
+            absolute.reset();
+            motion.reset();
+            coalescer.reset();
+        }
+        absolute_enabled = absolute_settings.enabled;
+        absolute.set_settings(absolute_settings);
+
+        cursor.set_layout(desktop_layout_.load());
+
+        if(held == 0)
+            hold_time = process_time;
+
+        int fused = 0;
+        std::int64_t filter_time = 0;
+        std::int64_t fusion_time = 0;
+
+        // Packets are taken from the queue a block at a time, each channel of a block is stored contiguously
+        SampleBlock block;
+        double timestamp = 0.0;
+        while(spatial_->pop_samples(block))
+        {
+            for(std::size_t i = 0; i < block.count; ++i)
+            {
+                queue_latency_.record(process_time - block.ingest_time[i]);
+                if(held < kMaxBurst)
+                    ingest_times[held++] = block.ingest_time[i];
+            }
+
+            // The bias is removed before anything downstream sees the angular rate, the noise
+            // measured alongside it tunes the Kalman filter
+            bias.update(block);
+            bias.correct(block);
+            filter.set_rate_noise(bias.noise());
+
+            const std::int64_t filter_start = monotonic_ns();
+            filter.process(block);
+            filter_time += monotonic_ns() - filter_start;
+
+            // Every packet is fused, the orientation is only as good as the stream it has seen
+            for(std::size_t i = 0; i < block.count; ++i)
+            {
+                const SpatialSample sample = block.sample(i);
+
+                const std::int64_t fusion_start = monotonic_ns();
+                orientation.update(sample);
+                fusion_time += monotonic_ns() - fusion_start;
+                ++fused;
+
+                if(absolute_enabled)
+                    absolute.update(orientation.orientation(), sample, settings.invert);
+            }
+
+            if(!absolute_enabled)
+                motion.integrate(block);
+
+            timestamp = block.timestamp[block.count - 1];
+        }
+
+        if(fused > 0)
+        {
+            filter_cost_.record(filter_time / fused);
+            fusion_cost_.record(fusion_time / fused);
+        }
+        samples += fused;
+
+        // Collect the whole pixels travelled, the sub-pixel remainder is carried over to the next burst
+        int displacement_x;
+        int displacement_y;
+        motion.take_pixels(displacement_x, displacement_y);
+        coalescer.add(displacement_x, displacement_y);
+
+        bool moved = false;
+        if(coalescer.due(process_time * 1.0e-9))
+            moved = release(process_time);
+
+        // While the pipeline leaves the cursor alone, check whether something else has moved it. A relative output's
+        // cursor cannot be read back, the position Qt reports may be another cursor's altogether
+        if(!relative && !moved && !moving && !coalescer.pending() && process_time - move_time >= kResyncSettle && process_time - resync_time >= kResyncInterval)
+        {
+            // Only a reading taken once the last move had landed can tell
+            resync_time = process_time;
+            const CursorReading real = real_cursor_.load();
+            if(real.time - move_time >= kResyncSettle && !cursor.matches(real.position.x(), real.position.y()))
+            {
+                cursor.sync(real.position.x(), real.position.y());
+                position = real.position;
+                ++resyncs;
+            }
+        }
+
+        PipelineStatus status;
+        status.residual_x = motion.residual_x();
+        status.residual_y = motion.residual_y();
+        status.orientation = orientation.orientation();
+        status.gyro_bias = bias.bias();
+        status.gyro_noise = bias.noise();
+        status.still = bias.still();
+        status.tremor = filter.tremor().detected();
+        status.tremor_frequency = filter.tremor().frequency();
+        status.tremor_amplitude = filter.tremor().amplitude();
+        status.cursor_resyncs = resyncs;
+        status.samples_consumed = samples;
+        status.moves_emitted = moves;
+        status_.store(status);
+
+        // Dwelling is timed by the sensor's own clock, the same as when replaying a recorded session
+        if(!dwell_started)
+        {
+            dwell.reset(position.x(), position.y(), timestamp);
+            dwell_started = true;
+        }
+
+        switch(dwell.update(position.x(), position.y(), timestamp))
+        {
+        case DwellEvent::kArmed:
+            countdown = true;
+            emit dwell_armed(position);
+            break;
+        case DwellEvent::kCancelled:
+            countdown = false;
+            emit dwell_cancelled();
+            break;
+        case DwellEvent::kClick:
+            // The overlay performs the click once its countdown completes
+            countdown = false;
+            break;
+        default:
+            break;
+        }
+    }
+}
@@ -0,0 +1,156 @@
+#ifndef POINTER_PIPELINE_H
+#define POINTER_PIPELINE_H
+
+#include <QThread>
+#include <QPoint>
+#include "absolute_pointer.h"
+#include "cursor_model.h"
+#include "cursor_output.h"
+#include "dwell_detector.h"
+#include "filter_bank.h"
+#include "gyro_bias_estimator.h"
+#include "latency_histogram.h"
+#include "orientation_filter.h"
+#include "output_coalescer.h"
+#include "pointer_motion.h"
+#include "seq_lock.h"
+
+class PhidgetSpatial;
+class QTimer;
+
+/**
+ * @brief Snapshot of the pipeline state for display purposes
+ */
+struct PipelineStatus
+{
+
+    double residual_x = 0.0;
+    double residual_y = 0.0;
+
+    Quatd orientation;
+
+    Vec3d gyro_bias;
+    bool still = false;
+
+    // Variance of the angular rate at rest, zero until measured
+    Vec3d gyro_noise;
+
+    bool tremor = false;
+    double tremor_frequency = 0.0;
+    double tremor_amplitude = 0.0;
+
+    // Times the tracked cursor position was replaced after something else moved the cursor
+    long long cursor_resyncs = 0;
+
+    // Packets consumed and cursor moves made from them, fewer moves than packets when coalescing
+    long long samples_consumed = 0;
+    long long moves_emitted = 0;
+
+};
+
+/**
+ * @brief Dedicated thread that wakes whenever the PhidgetSpatial reports new packets, filters them, fuses them into
+ * an orientation estimate, converts them into cursor movement (relative to the head's rotation or
+ * absolutely from its orientation), moves the cursor through a CursorOutput and tracks dwelling for the dwell click
+ *
+ * The cursor is moved as soon as a burst of packets has been processed, or at the cadence of the OutputSettings,
+ * in which case the thread also wakes for moves that fall between packets
+ */
+class PointerPipeline : public QThread
+{
+    Q_OBJECT
+
+public:
+
+    explicit PointerPipeline(PhidgetSpatial* spatial, CursorOutput* output, QObject *parent = 0);
+    ~PointerPipeline();
+
+    void set_settings(const PointerSettings& settings);
+    void set_dwell_settings(const DwellSettings& settings);
+    void set_filter_settings(const FilterSettings& settings);
+    void set_orientation_settings(const OrientationSettings& settings);
+    void set_absolute_settings(const AbsoluteSettings& settings);
+    void set_desktop_layout(const DesktopLayout& layout);
+    void set_output_settings(const OutputSettings& settings);
+
+    PipelineStatus status() const;
+
+    const LatencyHistogram& queue_latency() const;
+    const LatencyHistogram& processing_latency() const;
+    const LatencyHistogram& end_to_end_latency() const;
+    const LatencyHistogram& filter_cost() const;
+    const LatencyHistogram& fusion_cost() const;
+
+    void reset_latency();
+
+    void start(QThread::Priority priority = QThread::InheritPriority);
+    void stop();
+
+signals:
+
+    void cursor_moved(const QPoint& position);
+    void dwell_armed(const QPoint& position);
+    void dwell_cancelled();
+    void detached();
+
+protected:
+
+    void run() override;
+
+private slots:
+
+    void read_cursor();
+
+private:
+
+    // Position of the real cursor and when it was read (nanoseconds of the monotonic clock)
+    struct CursorReading
+    {
+        QPoint position;
+        std::int64_t time = 0;
+    };
+
+    // Longest time to sleep without packets before checking for attachment and interruption (milliseconds)
+    const int kWaitTimeout = 100;
+
+    // Maximum number of packets of a single move whose ingestion time is retained
+    static const int kMaxBurst = 64;
+
+    // The real cursor is compared with the tracked position at most this often, and only once the
+    // pipeline has not moved it for a while so that the last move has landed (nanoseconds)
+    const std::int64_t kResyncInterval = 250000000;
+    const std::int64_t kResyncSettle = 50000000;
+
+    // QCursor is only safe to use from the GUI thread, which reads the real cursor this often for the pipeline while it
+    // runs with an absolute output (milliseconds)
+    const int kCursorReadInterval = 100;
+
+    PhidgetSpatial* spatial_;
+    CursorOutput* output_;
+
+    QTimer* cursor_timer_;
+    SeqLock<CursorReading> real_cursor_;
+
+    SeqLock<PointerSettings> settings_;
+    SeqLock<DwellSettings> dwell_settings_;
+    SeqLock<FilterSettings> filter_settings_;
+    SeqLock<OrientationSettings> orientation_settings_;
+    SeqLock<AbsoluteSettings> absolute_settings_;
+    SeqLock<DesktopLayout> desktop_layout_;
+    SeqLock<OutputSettings> output_settings_;
+    SeqLock<PipelineStatus> status_;
+
+    // Packet ingestion to the start of processing
+    LatencyHistogram queue_latency_;
+    // Start of processing to the cursor move
+    LatencyHistogram processing_latency_;
+    // Packet ingestion to the cursor move
+    LatencyHistogram end_to_end_latency_;
+    // Filter bank time per packet
+    LatencyHistogram filter_cost_;
+    // Orientation fusion time per packet
+    LatencyHistogram fusion_cost_;
+
+};
+
+#endif // POINTER_PIPELINE_H
@@ -0,0 +1,101 @@
+#include "qt_cursor_output.h"
+#include "monotonic_clock.h"
+#include <QCursor>
+#include <QtGlobal>
+#ifdef _WIN32
+#include <Windows.h>
+#pragma comment (lib,"User32.lib")
+#endif
+
+/**
+ * @brief Initialize, moves are placed on the thread the output is created in
+ * @param parent parent object
+ */
+QtCursorOutput::QtCursorOutput(QObject *parent) : QObject(parent), queued_(false), requested_(0), placed_(0), landed_time_(0)
+{
+}
+
+/**
+ * @brief Nothing to prepare, the cursor is always available through Qt
+ */
+bool QtCursorOutput::open()
+{
+    return true;
+}
+
+/**
+ * @brief Nothing to release
+ */
+void QtCursorOutput::close()
+{
+}
+
+/**
+ * @brief The cursor is placed at an absolute position
+ */
+bool QtCursorOutput::relative() const
+{
+    return false;
+}
+
+/**
+ * @brief Places the cursor at the expected position, may be called from any one thread
+ * @param dx horizontal displacement (pixels), unused
+ * @param dy vertical displacement (pixels), unused
+ * @param x horizontal position (pixels across the virtual desktop)
+ * @param y vertical position (pixels across the virtual desktop)
+ */
+void QtCursorOutput::move(const int& dx, const int& dy, const int& x, const int& y)
+{
+    Q_UNUSED(dx);
+    Q_UNUSED(dy);
+
+#ifdef _WIN32
+    // SetCursorPos is safe from any thread, the cursor is placed without waiting for the GUI thread
+    SetCursorPos(x, y);
+    landed_time_ = monotonic_ns();
+#else
+    // The position is published before the count, a placement that counts this move also places it
+    target_.store(QPoint(x, y));
+    requested_.fetch_add(1, std::memory_order_release);
+    if(!queued_.exchange(true))
+        QMetaObject::invokeMethod(this, "place", Qt::QueuedConnection);
+#endif
+}
+
+/**
+ * @brief Places the cursor at the latest position asked for, runs on the GUI thread where QCursor has to be used
+ */
+void QtCursorOutput::place()
+{
+    // Cleared before reading the position so that a move made meanwhile queues another placement
+    queued_ = false;
+    const std::uint64_t requested = requested_.load(std::memory_order_acquire);
+    QCursor::setPos(target_.load());
+    landed_time_ = monotonic_ns();
+    placed_.store(requested, std::memory_order_release);
+}
+
+/**
+ * @brief Returns whether the GUI thread has placed every move made so far
+ * @param time receives when the cursor was last placed (nanoseconds of the monotonic clock)
+ */
+bool QtCursorOutput::landed(std::int64_t& time) const
+{
+    if(placed_.load(std::memory_order_acquire) != requested_.load(std::memory_order_relaxed))
+        return false;
+    time = landed_time_;
+    return true;
+}
+
+/**
+ * @brief Clicks the left button
+ */
+void QtCursorOutput::click()
+{
+#ifdef _WIN32
+    mouse_event(MOUSEEVENTF_LEFTDOWN | MOUSEEVENTF_LEFTUP, NULL, NULL, NULL, NULL);
+#else
+    qWarning("Clicking is not supported by the Qt cursor output on this platform, use --output uinput");
+#endif
+}
@@ -0,0 +1,55 @@
+#ifndef QT_CURSOR_OUTPUT_H
+#define QT_CURSOR_OUTPUT_H
+
+#include <QObject>
+#include <QPoint>
+#include <atomic>
+#include "cursor_output.h"
+#include "seq_lock.h"
+
+/**
+ * @brief Moves the cursor with the Win32 SetCursorPos and clicks with mouse_event on Windows, elsewhere moves it with
+ * QCursor::setPos
+ *
+ * SetCursorPos places the cursor straight from the pipeline's thread. QCursor is only safe to use from the GUI thread,
+ * so elsewhere moves are handed to the thread the output was created in. Only the latest position is kept, moves made
+ * before the GUI thread gets round to placing the cursor are overtaken rather than queued up behind each other.
+ *
+ * Qt has no way of clicking outside its own windows, elsewhere clicks are dropped with a warning
+ * and the uinput output should be used instead.
+ */
+class QtCursorOutput : public QObject, public CursorOutput
+{
+    Q_OBJECT
+
+public:
+
+    explicit QtCursorOutput(QObject *parent = 0);
+
+    bool open() override;
+    void close() override;
+
+    bool relative() const override;
+
+    void move(const int& dx, const int& dy, const int& x, const int& y) override;
+    bool landed(std::int64_t& time) const override;
+    void click() override;
+
+private slots:
+
+    void place();
+
+private:
+
+    // Latest position asked for, and whether placing it is already queued on the GUI thread
+    SeqLock<QPoint> target_;
+    std::atomic<bool> queued_;
+
+    // Moves asked for and placed so far, and when the cursor was last placed (nanoseconds of the monotonic clock)
+    std::atomic<std::uint64_t> requested_;
+    std::atomic<std::uint64_t> placed_;
+    std::atomic<std::int64_t> landed_time_;
+
+};
+
+#endif // QT_CURSOR_OUTPUT_H
@@ -0,0 +1,125 @@
+#include "rate_kalman.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+const double kPi = 3.14159265358979323846;
+
+}
+
+RateKalman::RateKalman() : measurement_noise_(kDefaultMeasurementNoise), process_noise_(kDefaultProcessNoise)
+{
+    reset();
+}
+
+/**
+ * \brief Forgets the state, the next measurement restarts the filter
+ */
+void RateKalman::reset()
+{
+    rate_ = 0.0;
+    derivative_ = 0.0;
+    p_rate_ = 0.0;
+    p_cross_ = 0.0;
+    p_derivative_ = 0.0;
+    initialized_ = false;
+}
+
+/**
+ * \brief Sets the variance of the gyroscope's measurement noise, takes effect from the next packet
+ * \param variance variance ((degrees per second)^2), zero or less restores the typical variance
+ */
+void RateKalman::set_measurement_noise(const double& variance)
+{
+    measurement_noise_ = variance > 0.0 ? std::max(variance, kMinMeasurementNoise) : kDefaultMeasurementNoise;
+}
+
+/**
+ * \brief Sets the spectral density of the jerk driving the angular acceleration, takes effect from the next packet
+ * \param density spectral density ((degrees per second cubed)^2 per hertz), zero or less restores the default
+ */
+void RateKalman::set_process_noise(const double& density)
+{
+    process_noise_ = density > 0.0 ? density : kDefaultProcessNoise;
+}
+
+/**
+ * \brief Sets the process noise for a steady-state bandwidth, which the filter has while the measurement
+ * noise is a typical gyroscope's. A noisier gyroscope is smoothed more and a quieter one less.
+ * \param frequency bandwidth (hertz)
+ * \param sample_rate packets per second
+ */
+void RateKalman::set_bandwidth(const double& frequency, const double& sample_rate)
+{
+    // In steady state the filter is a second order low-pass with a natural frequency of
+    // (q / (r dt))^(1/4), r dt being the measurement noise as a spectral density
+    const double omega = 2.0 * kPi * frequency;
+    set_process_noise(kDefaultMeasurementNoise / std::max(sample_rate, 1.0) * omega * omega * omega * omega);
+}
+
+/**
+ * \brief Advances the state to a new packet and corrects it with the packet's angular rate
+ * \param rate measured angular rate (degrees per second)
+ * \param dt time elapsed since the previous packet (seconds), zero or less restarts the filter
+ */
+void RateKalman::update(const double& rate, const double& dt)
+{
+    // The first packet of a stream (or after a gap) is taken as it is, with nothing known of the acceleration
+    if (!initialized_ || dt <= 0.0)
+    {
+        rate_ = rate;
+        derivative_ = 0.0;
+        p_rate_ = measurement_noise_;
+        p_cross_ = 0.0;
+        p_derivative_ = kInitialDerivativeVariance;
+        initialized_ = true;
+        return;
+    }
+
+    // Predict: F = [1 dt; 0 1], Q = q [dt^3/3 dt^2/2; dt^2/2 dt]
+    const double dt2 = dt * dt;
+    rate_ += derivative_ * dt;
+    p_rate_ += dt * (2.0 * p_cross_ + dt * p_derivative_) + process_noise_ * dt2 * dt / 3.0;
+    p_cross_ += dt * p_derivative_ + process_noise_ * dt2 / 2.0;
+    p_derivative_ += process_noise_ * dt;
+
+    // Correct with the measured rate, H = [1 0]
+    const double innovation = rate - rate_;
+    const double gain_rate = p_rate_ / (p_rate_ + measurement_noise_);
+    const double gain_derivative = p_cross_ / (p_rate_ + measurement_noise_);
+    rate_ += gain_rate * innovation;
+    derivative_ += gain_derivative * innovation;
+    p_derivative_ -= gain_derivative * p_cross_;
+    p_cross_ -= gain_rate * p_cross_;
+    p_rate_ -= gain_rate * p_rate_;
+}
+
+/**
+ * \brief Returns the filtered angular rate (degrees per second)
+ */
+double RateKalman::rate() const
+{
+    return rate_;
+}
+
+/**
+ * \brief Returns the filtered angular acceleration (degrees per second squared)
+ */
+double RateKalman::derivative() const
+{
+    return derivative_;
+}
+
+/**
+ * \brief Returns the angular rate extrapolated ahead at the current acceleration (degrees per second)
+ * \param look_ahead time ahead (seconds)
+ */
+double RateKalman::predict(const double& look_ahead) const
+{
+    // The extrapolation changes the rate by no more than the rate itself, so a head at rest is not
+    // moved by noise in the acceleration and a slowing head is not predicted to turn back
+    const double limit = std::abs(rate_);
+    return rate_ + std::min(std::max(derivative_ * look_ahead, -limit), limit);
+}
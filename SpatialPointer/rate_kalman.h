@@ -0,0 +1,70 @@
+#pragma once
+
+/**
+ * \brief Kalman filter tracking the angular rate of one axis and its rate of change, used to
+ * extrapolate the rate a short time ahead
+ *
+ * The model is constant angular acceleration driven by white jerk: between packets the rate
+ * advances by the acceleration, and the acceleration drifts randomly with the process noise's
+ * spectral density. Each packet measures the rate with the gyroscope's noise variance, a typical
+ * PhidgetSpatial's until the device's own has been measured. The state and
+ * covariance are two scalars and a symmetric 2x2 matrix, updated in closed form, so the filter
+ * never allocates and costs a handful of multiplications per packet.
+ *
+ * Extrapolating the rate by a look-ahead shifts everything integrated from it by the same time, so
+ * feeding the extrapolated rate to the pointer moves the cursor to where the head will be pointing
+ * after the look-ahead, hiding that much of the sensor-to-display latency. The extrapolation is
+ * bounded by the rate itself, at rest the acceleration is mostly noise and would make the cursor
+ * jitter.
+ *
+ * The default process noise suits prediction, it follows a head movement within a few packets and
+ * hardly smooths at all. Smoothing wants a far lower one, set_bandwidth picks it from the filter's
+ * steady-state bandwidth.
+ */
+class RateKalman
+{
+
+ public:
+
+    RateKalman();
+
+    void reset();
+
+    void set_measurement_noise(const double& variance);
+    void set_process_noise(const double& density);
+    void set_bandwidth(const double& frequency, const double& sample_rate);
+
+    void update(const double& rate, const double& dt);
+
+    double rate() const;
+    double derivative() const;
+    double predict(const double& look_ahead) const;
+
+ private:
+
+    // Spectral density of the jerk driving the angular acceleration ((degrees per second cubed)^2
+    // per hertz), large enough to follow the onset of a head movement within a few packets
+    const double kDefaultProcessNoise = 2.0e6;
+
+    // Variance of a typical gyroscope's measurement noise ((degrees per second)^2), and the
+    // smallest accepted, a filter trusting its measurements completely would not filter at all
+    const double kDefaultMeasurementNoise = 0.1;
+    const double kMinMeasurementNoise = 1.0e-4;
+
+    // Variance of the angular acceleration when a stream starts ((degrees per second squared)^2)
+    const double kInitialDerivativeVariance = 1.0e6;
+
+    double measurement_noise_;
+    double process_noise_;
+
+    double rate_;
+    double derivative_;
+
+    // Covariance of the rate and its derivative
+    double p_rate_;
+    double p_cross_;
+    double p_derivative_;
+
+    bool initialized_;
+
+};
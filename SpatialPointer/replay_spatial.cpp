@@ -0,0 +1,137 @@
+#include "replay_spatial.h"
+#include "phidget_spatial.h"
+#include <chrono>
+
+ReplaySpatial::ReplaySpatial(const std::string& path, const double& speed) : path_(path), speed_(speed), sample_rate_(0.0), running_(false)
+{
+}
+
+ReplaySpatial::~ReplaySpatial()
+{
+    close();
+}
+
+/**
+ * \brief Maps the session and starts replaying it on a dedicated thread, returns false if it could not be read
+ * \param spatial receiver of the packets
+ */
+bool ReplaySpatial::open(PhidgetSpatial* spatial)
+{
+    close();
+
+    if (!reader_.open(path_))
+    {
+        return false;
+    }
+
+    // The recorded timestamps are kept whatever the replay speed, so is their rate
+    sample_rate_ = 0.0;
+    if (reader_.record_count() > 1 && reader_.duration() > 0.0)
+    {
+        sample_rate_ = (reader_.record_count() - 1) / reader_.duration();
+    }
+
+    running_ = true;
+    thread_ = std::thread(&ReplaySpatial::run, this, spatial);
+    return true;
+}
+
+/**
+ * \brief Stops the replay and waits for the replay thread to finish
+ */
+void ReplaySpatial::close()
+{
+    running_ = false;
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+    reader_.close();
+}
+
+/**
+ * \brief Returns the rate of the recorded packets, 0 when the session is too short to tell
+ */
+double ReplaySpatial::sample_rate() const
+{
+    return sample_rate_;
+}
+
+/**
+ * \brief Replay thread, delivers every recorded packet once it is due
+ * \param spatial receiver of the packets
+ */
+void ReplaySpatial::run(PhidgetSpatial* spatial)
+{
+    CPhidgetSpatial_SpatialEventData packets[kMaxBurst];
+    CPhidgetSpatial_SpatialEventDataHandle handles[kMaxBurst];
+    for (int i = 0; i < kMaxBurst; ++i)
+    {
+        handles[i] = &packets[i];
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const double first_timestamp = reader_.first_timestamp();
+    int burst = 0;
+
+    for (std::size_t c = 0; c < reader_.chunk_count() && running_; ++c)
+    {
+        const SessionChunk& chunk = reader_.chunk(c);
+        for (std::uint32_t r = 0; r < chunk.count && running_; ++r)
+        {
+            const SessionRecord& record = chunk.records[r];
+
+            // Deliver the packets gathered so far before waiting for this one to become due
+            if (speed_ > 0.0)
+            {
+                const auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>((record.timestamp - first_timestamp) / speed_));
+                if (due > std::chrono::steady_clock::now())
+                {
+                    if (burst > 0)
+                    {
+                        spatial->inject_packets(handles, burst);
+                        burst = 0;
+                    }
+                    std::this_thread::sleep_until(due);
+                }
+            }
+
+            CPhidgetSpatial_SpatialEventData& packet = packets[burst++];
+            for (int i = 0; i < 3; ++i)
+            {
+                packet.acceleration[i] = record.acceleration[i];
+                packet.angularRate[i] = record.angular_rate[i];
+                packet.magneticField[i] = record.magnetic_field[i];
+            }
+            packet.timestamp.seconds = static_cast<int>(record.timestamp);
+            packet.timestamp.microseconds = static_cast<int>((record.timestamp - packet.timestamp.seconds) * 1000000.0 + 0.5);
+            if (packet.timestamp.microseconds >= 1000000)
+            {
+                packet.timestamp.seconds += 1;
+                packet.timestamp.microseconds -= 1000000;
+            }
+
+            if (burst == kMaxBurst)
+            {
+                // When replaying as fast as possible wait for the consumer rather than overflowing its queue
+                while (speed_ <= 0.0 && running_ && spatial->pending_samples() + kMaxBurst > spatial->sample_capacity())
+                {
+                    std::this_thread::yield();
+                }
+                spatial->inject_packets(handles, burst);
+                burst = 0;
+            }
+        }
+    }
+
+    if (burst > 0)
+    {
+        spatial->inject_packets(handles, burst);
+    }
+
+    // The session has ended, behave as though the sensor was unplugged
+    if (running_)
+    {
+        spatial->source_detatched();
+    }
+}
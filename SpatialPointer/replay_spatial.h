@@ -0,0 +1,45 @@
+#pragma once
+#include <atomic>
+#include <string>
+#include <thread>
+#include "session_reader.h"
+#include "spatial_source.h"
+
+/**
+ * \brief Source that replays a recorded session with its original hardware timestamps
+ *
+ * Packets are delivered at their recorded pace scaled by the replay speed, or as fast as possible
+ * when the speed is zero. The PhidgetSpatial is detatched once the session ends.
+ */
+class ReplaySpatial : public SpatialSource
+{
+
+ public:
+
+    ReplaySpatial(const std::string& path, const double& speed);
+    ~ReplaySpatial();
+
+    bool open(PhidgetSpatial* spatial) override;
+    void close() override;
+
+    double sample_rate() const override;
+
+ private:
+
+    // Packets due at the same time are delivered together, up to this many at once
+    static const int kMaxBurst = 64;
+
+    std::string path_;
+    double speed_;
+
+    SessionReader reader_;
+
+    // Measured from the session's timestamps when it is opened (packets per second)
+    double sample_rate_;
+
+    std::thread thread_;
+    std::atomic<bool> running_;
+
+    void run(PhidgetSpatial* spatial);
+
+};
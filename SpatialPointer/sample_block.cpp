@@ -0,0 +1,52 @@
+#include "sample_block.h"
+
+/**
+ * \brief Empties the block
+ */
+void SampleBlock::clear()
+{
+    count = 0;
+}
+
+/**
+ * \brief Returns whether the block holds kCapacity packets
+ */
+bool SampleBlock::full() const
+{
+    return count == kCapacity;
+}
+
+/**
+ * \brief Appends a packet, the block must not be full
+ * \param sample packet to append
+ */
+void SampleBlock::push(const SpatialSample& sample)
+{
+    channels[kAccelerationX][count] = static_cast<float>(sample.acceleration.x);
+    channels[kAccelerationY][count] = static_cast<float>(sample.acceleration.y);
+    channels[kAccelerationZ][count] = static_cast<float>(sample.acceleration.z);
+    channels[kAngularRateX][count] = static_cast<float>(sample.angular_rate.x);
+    channels[kAngularRateY][count] = static_cast<float>(sample.angular_rate.y);
+    channels[kAngularRateZ][count] = static_cast<float>(sample.angular_rate.z);
+    channels[kMagneticFieldX][count] = static_cast<float>(sample.magnetic_field.x);
+    channels[kMagneticFieldY][count] = static_cast<float>(sample.magnetic_field.y);
+    channels[kMagneticFieldZ][count] = static_cast<float>(sample.magnetic_field.z);
+    timestamp[count] = sample.timestamp;
+    ingest_time[count] = sample.ingest_time;
+    ++count;
+}
+
+/**
+ * \brief Returns a single packet of the block
+ * \param index index of the packet, less than count
+ */
+SpatialSample SampleBlock::sample(const std::size_t& index) const
+{
+    SpatialSample sample;
+    sample.acceleration = Vec3d(channels[kAccelerationX][index], channels[kAccelerationY][index], channels[kAccelerationZ][index]);
+    sample.angular_rate = Vec3d(channels[kAngularRateX][index], channels[kAngularRateY][index], channels[kAngularRateZ][index]);
+    sample.magnetic_field = Vec3d(channels[kMagneticFieldX][index], channels[kMagneticFieldY][index], channels[kMagneticFieldZ][index]);
+    sample.timestamp = timestamp[index];
+    sample.ingest_time = ingest_time[index];
+    return sample;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "spatial_sample.h"
+
+/**
+ * \brief A burst of packets stored as one array per channel (structure of arrays)
+ *
+ * Each channel is a contiguous array of floats, so the block kernels can process a whole channel of
+ * a burst a register at a time rather than one packet at a time.
+ */
+struct SampleBlock
+{
+
+    enum Channel
+    {
+        kAccelerationX,
+        kAccelerationY,
+        kAccelerationZ,
+        kAngularRateX,
+        kAngularRateY,
+        kAngularRateZ,
+        kMagneticFieldX,
+        kMagneticFieldY,
+        kMagneticFieldZ,
+        kChannelCount
+    };
+
+    // Largest number of packets in a block, longer bursts are split across several blocks
+    static const std::size_t kCapacity = 64;
+
+    std::size_t count = 0;
+
+    float channels[kChannelCount][kCapacity];
+
+    // Hardware timestamp (seconds) and monotonic ingestion time (nanoseconds) of each packet
+    double timestamp[kCapacity];
+    std::int64_t ingest_time[kCapacity];
+
+    float* channel(const Channel& channel) { return channels[channel]; }
+    const float* channel(const Channel& channel) const { return channels[channel]; }
+
+    void clear();
+    bool full() const;
+
+    void push(const SpatialSample& sample);
+    SpatialSample sample(const std::size_t& index) const;
+
+};
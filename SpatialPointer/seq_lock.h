@@ -0,0 +1,78 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+/**
+ * \brief Sequence lock publishing a whole value from a single writer thread to any number of readers
+ *
+ * The writer never waits. Readers never block the writer, a read that overlaps a write is
+ * retried so a reader always observes one complete value rather than a mix of two.
+ */
+template<class T>
+class SeqLock
+{
+    static_assert(std::is_trivially_copyable<T>::value, "SeqLock requires a trivially copyable type");
+
+ public:
+
+    SeqLock() : sequence_(0)
+    {
+        store(T());
+    }
+
+    /**
+     * \brief Publishes a new value (writer thread only)
+     * \param value value to publish
+     */
+    void store(const T& value)
+    {
+        std::uint64_t words[kWords] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        // An odd sequence marks a write in progress
+        const std::uint32_t sequence = sequence_.load(std::memory_order_relaxed);
+        sequence_.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (std::size_t i = 0; i < kWords; ++i)
+        {
+            words_[i].store(words[i], std::memory_order_relaxed);
+        }
+
+        sequence_.store(sequence + 2, std::memory_order_release);
+    }
+
+    /**
+     * \brief Returns the most recently published value
+     */
+    T load() const
+    {
+        std::uint64_t words[kWords];
+        std::uint32_t before;
+        std::uint32_t after;
+        do
+        {
+            before = sequence_.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i < kWords; ++i)
+            {
+                words[i] = words_[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence_.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+ private:
+
+    static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+    std::atomic<std::uint32_t> sequence_;
+    std::atomic<std::uint64_t> words_[kWords];
+
+};
@@ -0,0 +1,75 @@
+#include "session_directory.h"
+#include "session_format.h"
+#include <algorithm>
+#include <cstring>
+#ifdef _WIN32
+#include <Windows.h>
+#else
+#include <dirent.h>
+#endif
+
+/**
+ * \brief Returns the paths of every session file within a directory, sorted by name
+ * \param directory directory to search (not recursive)
+ */
+std::vector<std::string> list_sessions(const std::string& directory)
+{
+    std::vector<std::string> names;
+
+#ifdef _WIN32
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA((directory + "\\*" + kSessionExtension).c_str(), &data);
+    if (find != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if (!(data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY))
+            {
+                names.push_back(data.cFileName);
+            }
+        } while (FindNextFileA(find, &data));
+        FindClose(find);
+    }
+#else
+    DIR* handle = opendir(directory.c_str());
+    if (handle != nullptr)
+    {
+        const std::size_t extension_length = std::strlen(kSessionExtension);
+        while (dirent* entry = readdir(handle))
+        {
+            const std::string name = entry->d_name;
+            if (name.size() > extension_length && name.compare(name.size() - extension_length, extension_length, kSessionExtension) == 0)
+            {
+                names.push_back(name);
+            }
+        }
+        closedir(handle);
+    }
+#endif
+
+    std::sort(names.begin(), names.end());
+
+    std::vector<std::string> paths;
+    for (const std::string& name : names)
+    {
+        paths.push_back(directory + "/" + name);
+    }
+    return paths;
+}
+
+/**
+ * \brief Returns the file name of a session without its directory or extension
+ * \param path path of the session file
+ */
+std::string session_name(const std::string& path)
+{
+    const std::size_t separator = path.find_last_of("/\\");
+    std::string name = separator == std::string::npos ? path : path.substr(separator + 1);
+
+    const std::size_t extension_length = std::strlen(kSessionExtension);
+    if (name.size() > extension_length && name.compare(name.size() - extension_length, extension_length, kSessionExtension) == 0)
+    {
+        name.erase(name.size() - extension_length);
+    }
+    return name;
+}
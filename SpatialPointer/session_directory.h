@@ -0,0 +1,7 @@
+#pragma once
+#include <string>
+#include <vector>
+
+std::vector<std::string> list_sessions(const std::string& directory);
+
+std::string session_name(const std::string& path);
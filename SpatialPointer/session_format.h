@@ -0,0 +1,119 @@
+#pragma once
+#include <cstdint>
+#include "spatial_sample.h"
+
+/**
+ * Recorded sessions are stored as an append-only sequence of fixed size records (little endian):
+ *
+ *   SessionHeader
+ *   { SessionChunkHeader, SessionRecord * record_count } * chunk count
+ *   SessionIndexHeader, std::uint64_t chunk_offsets[chunk_count], SessionTrailer
+ *
+ * Chunks are written whole so an interrupted recording loses at most the final partial chunk. The
+ * index and trailer are appended when a recording is closed, readers rebuild the index by walking
+ * the chunk headers when they are missing.
+ */
+
+const std::uint32_t kSessionMagic = 0x594E5450;     // "PTNY"
+const std::uint32_t kSessionChunkMagic = 0x4B4E4843; // "CHNK"
+const std::uint32_t kSessionIndexMagic = 0x58444E49; // "INDX"
+const std::uint32_t kSessionTrailerMagic = 0x444E4550; // "PEND"
+
+const char* const kSessionExtension = ".pty";
+
+const std::uint32_t kSessionVersion = 1;
+const std::uint32_t kSessionChunkRecords = 1024;
+
+struct SessionHeader
+{
+
+    std::uint32_t magic;
+    std::uint32_t version;
+    std::uint32_t record_size;
+    std::uint32_t chunk_records;
+
+};
+
+struct SessionChunkHeader
+{
+
+    std::uint32_t magic;
+    std::uint32_t record_count;
+
+    // Hardware timestamps of the first and last record in the chunk (seconds)
+    double first_timestamp;
+    double last_timestamp;
+
+};
+
+struct SessionRecord
+{
+
+    // Hardware timestamp (seconds)
+    double timestamp;
+
+    float acceleration[3];
+    float angular_rate[3];
+    float magnetic_field[3];
+
+    std::uint32_t reserved;
+
+};
+
+struct SessionIndexHeader
+{
+
+    std::uint32_t magic;
+    std::uint32_t chunk_count;
+
+};
+
+struct SessionTrailer
+{
+
+    std::uint64_t index_offset;
+    std::uint32_t magic;
+    std::uint32_t reserved;
+
+};
+
+static_assert(sizeof(SessionHeader) == 16, "SessionHeader must be 16 bytes");
+static_assert(sizeof(SessionChunkHeader) == 24, "SessionChunkHeader must be 24 bytes");
+static_assert(sizeof(SessionRecord) == 48, "SessionRecord must be 48 bytes");
+static_assert(sizeof(SessionIndexHeader) == 8, "SessionIndexHeader must be 8 bytes");
+static_assert(sizeof(SessionTrailer) == 16, "SessionTrailer must be 16 bytes");
+
+/**
+ * \brief Converts a packet to its recorded form
+ * \param sample packet to convert
+ */
+inline SessionRecord to_session_record(const SpatialSample& sample)
+{
+    SessionRecord record;
+    record.timestamp = sample.timestamp;
+    record.acceleration[0] = static_cast<float>(sample.acceleration.x);
+    record.acceleration[1] = static_cast<float>(sample.acceleration.y);
+    record.acceleration[2] = static_cast<float>(sample.acceleration.z);
+    record.angular_rate[0] = static_cast<float>(sample.angular_rate.x);
+    record.angular_rate[1] = static_cast<float>(sample.angular_rate.y);
+    record.angular_rate[2] = static_cast<float>(sample.angular_rate.z);
+    record.magnetic_field[0] = static_cast<float>(sample.magnetic_field.x);
+    record.magnetic_field[1] = static_cast<float>(sample.magnetic_field.y);
+    record.magnetic_field[2] = static_cast<float>(sample.magnetic_field.z);
+    record.reserved = 0;
+    return record;
+}
+
+/**
+ * \brief Converts a recorded packet back into a packet
+ * \param record recorded packet
+ */
+inline SpatialSample to_spatial_sample(const SessionRecord& record)
+{
+    SpatialSample sample;
+    sample.timestamp = record.timestamp;
+    sample.acceleration = Vec3d(record.acceleration[0], record.acceleration[1], record.acceleration[2]);
+    sample.angular_rate = Vec3d(record.angular_rate[0], record.angular_rate[1], record.angular_rate[2]);
+    sample.magnetic_field = Vec3d(record.magnetic_field[0], record.magnetic_field[1], record.magnetic_field[2]);
+    return sample;
+}
@@ -0,0 +1,173 @@
+#include "session_reader.h"
+#include <cstring>
+
+SessionReader::SessionReader() : record_count_(0)
+{
+}
+
+/**
+ * \brief Maps a session file and locates its chunks, returns false if the file is not a valid session
+ * \param path path of the session file
+ */
+bool SessionReader::open(const std::string& path)
+{
+    close();
+
+    if (!file_.open(path) || file_.size() < sizeof(SessionHeader))
+    {
+        close();
+        return false;
+    }
+
+    SessionHeader header;
+    std::memcpy(&header, file_.data(), sizeof(header));
+    if (header.magic != kSessionMagic || header.version != kSessionVersion || header.record_size != sizeof(SessionRecord))
+    {
+        close();
+        return false;
+    }
+
+    // Recordings that were not closed cleanly have no index, walk the chunk headers instead
+    if (!read_index() && !scan_chunks())
+    {
+        close();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief Unmaps the session
+ */
+void SessionReader::close()
+{
+    file_.close();
+    chunks_.clear();
+    record_count_ = 0;
+}
+
+/**
+ * \brief Returns the number of chunks in the session
+ */
+std::size_t SessionReader::chunk_count() const
+{
+    return chunks_.size();
+}
+
+/**
+ * \brief Returns a chunk of the session, the records remain valid until the reader is closed
+ * \param index index of the chunk
+ */
+const SessionChunk& SessionReader::chunk(const std::size_t& index) const
+{
+    return chunks_[index];
+}
+
+/**
+ * \brief Returns the total number of records in the session
+ */
+std::uint64_t SessionReader::record_count() const
+{
+    return record_count_;
+}
+
+/**
+ * \brief Returns the hardware timestamp of the first record (seconds)
+ */
+double SessionReader::first_timestamp() const
+{
+    return chunks_.empty() ? 0.0 : chunks_.front().records[0].timestamp;
+}
+
+/**
+ * \brief Returns the time between the first and last records (seconds)
+ */
+double SessionReader::duration() const
+{
+    if (chunks_.empty())
+    {
+        return 0.0;
+    }
+    const SessionChunk& last = chunks_.back();
+    return last.records[last.count - 1].timestamp - first_timestamp();
+}
+
+/**
+ * \brief Locates the chunks using the index written when the recording was closed
+ */
+bool SessionReader::read_index()
+{
+    const std::size_t size = file_.size();
+    if (size < sizeof(SessionHeader) + sizeof(SessionIndexHeader) + sizeof(SessionTrailer))
+    {
+        return false;
+    }
+
+    SessionTrailer trailer;
+    std::memcpy(&trailer, file_.data() + size - sizeof(trailer), sizeof(trailer));
+    if (trailer.magic != kSessionTrailerMagic || trailer.index_offset + sizeof(SessionIndexHeader) > size - sizeof(trailer))
+    {
+        return false;
+    }
+
+    SessionIndexHeader index;
+    std::memcpy(&index, file_.data() + trailer.index_offset, sizeof(index));
+    const std::uint64_t offsets_begin = trailer.index_offset + sizeof(index);
+    if (index.magic != kSessionIndexMagic || offsets_begin + index.chunk_count * sizeof(std::uint64_t) > size - sizeof(trailer))
+    {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < index.chunk_count; ++i)
+    {
+        std::uint64_t offset;
+        std::memcpy(&offset, file_.data() + offsets_begin + i * sizeof(offset), sizeof(offset));
+        if (!add_chunk(offset))
+        {
+            chunks_.clear();
+            record_count_ = 0;
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief Locates the chunks by walking the chunk headers from the start of the file
+ */
+bool SessionReader::scan_chunks()
+{
+    std::uint64_t offset = sizeof(SessionHeader);
+    while (add_chunk(offset))
+    {
+        offset += sizeof(SessionChunkHeader) + chunks_.back().count * sizeof(SessionRecord);
+    }
+    return true;
+}
+
+/**
+ * \brief Validates the chunk at the given offset and adds it to the chunk list
+ * \param offset offset of the chunk header within the file
+ */
+bool SessionReader::add_chunk(const std::uint64_t& offset)
+{
+    if (offset + sizeof(SessionChunkHeader) > file_.size())
+    {
+        return false;
+    }
+
+    SessionChunkHeader header;
+    std::memcpy(&header, file_.data() + offset, sizeof(header));
+    const std::uint64_t records_offset = offset + sizeof(header);
+    if (header.magic != kSessionChunkMagic || header.record_count == 0 || records_offset + header.record_count * sizeof(SessionRecord) > file_.size())
+    {
+        return false;
+    }
+
+    SessionChunk chunk;
+    chunk.records = reinterpret_cast<const SessionRecord*>(file_.data() + records_offset);
+    chunk.count = header.record_count;
+    chunks_.push_back(chunk);
+    record_count_ += chunk.count;
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "memory_mapped_file.h"
+#include "session_format.h"
+
+/**
+ * \brief Contiguous run of records within a memory mapped session
+ */
+struct SessionChunk
+{
+
+    const SessionRecord* records;
+    std::uint32_t count;
+
+};
+
+/**
+ * \brief Memory mapped, zero copy reader of a recorded session
+ */
+class SessionReader
+{
+
+ public:
+
+    SessionReader();
+
+    bool open(const std::string& path);
+    void close();
+
+    std::size_t chunk_count() const;
+    const SessionChunk& chunk(const std::size_t& index) const;
+
+    std::uint64_t record_count() const;
+
+    double first_timestamp() const;
+    double duration() const;
+
+ private:
+
+    MemoryMappedFile file_;
+
+    std::vector<SessionChunk> chunks_;
+    std::uint64_t record_count_;
+
+    bool read_index();
+    bool scan_chunks();
+    bool add_chunk(const std::uint64_t& offset);
+
+};
@@ -0,0 +1,175 @@
+#include "session_recorder.h"
+#include <chrono>
+
+SessionRecorder::SessionRecorder() : file_(nullptr), running_(false), written_(0), offset_(0)
+{
+}
+
+SessionRecorder::~SessionRecorder()
+{
+    close();
+}
+
+/**
+ * \brief Creates the session file and starts the writer thread, returns false if the file could not be created
+ * \param path path of the session file
+ */
+bool SessionRecorder::open(const std::string& path)
+{
+    close();
+
+    file_ = std::fopen(path.c_str(), "wb");
+    if (file_ == nullptr)
+    {
+        return false;
+    }
+
+    SessionHeader header;
+    header.magic = kSessionMagic;
+    header.version = kSessionVersion;
+    header.record_size = sizeof(SessionRecord);
+    header.chunk_records = kSessionChunkRecords;
+    std::fwrite(&header, sizeof(header), 1, file_);
+    offset_ = sizeof(header);
+
+    chunk_.clear();
+    chunk_.reserve(kSessionChunkRecords);
+    chunk_offsets_.clear();
+    written_ = 0;
+    queue_.clear();
+
+    running_ = true;
+    thread_ = std::thread(&SessionRecorder::run, this);
+    return true;
+}
+
+/**
+ * \brief Writes every queued packet followed by the chunk index and closes the file
+ */
+void SessionRecorder::close()
+{
+    if (file_ == nullptr)
+    {
+        return;
+    }
+
+    running_ = false;
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+
+    drain();
+    write_chunk();
+    write_index();
+
+    std::fclose(file_);
+    file_ = nullptr;
+}
+
+/**
+ * \brief Returns true while a session file is being written
+ */
+bool SessionRecorder::is_open() const
+{
+    return file_ != nullptr;
+}
+
+/**
+ * \brief Queues a packet for writing, never blocks (ingestion thread only)
+ * \param sample packet to record
+ */
+void SessionRecorder::record(const SpatialSample& sample)
+{
+    queue_.push(sample);
+}
+
+/**
+ * \brief Returns the number of packets written to the file
+ */
+std::uint64_t SessionRecorder::records_written() const
+{
+    return written_.load(std::memory_order_relaxed);
+}
+
+/**
+ * \brief Returns the number of packets lost because the writer fell behind
+ */
+std::uint64_t SessionRecorder::records_dropped() const
+{
+    return queue_.overflow_count();
+}
+
+/**
+ * \brief Writer thread, periodically moves queued packets into the file
+ */
+void SessionRecorder::run()
+{
+    while (running_)
+    {
+        drain();
+        std::this_thread::sleep_for(std::chrono::milliseconds(kFlushInterval));
+    }
+}
+
+/**
+ * \brief Moves every queued packet into the current chunk, writing each chunk as it fills
+ */
+void SessionRecorder::drain()
+{
+    SpatialSample sample;
+    while (queue_.pop(sample))
+    {
+        chunk_.push_back(to_session_record(sample));
+        if (chunk_.size() == kSessionChunkRecords)
+        {
+            write_chunk();
+        }
+    }
+}
+
+/**
+ * \brief Appends the current chunk to the file
+ */
+void SessionRecorder::write_chunk()
+{
+    if (chunk_.empty())
+    {
+        return;
+    }
+
+    SessionChunkHeader header;
+    header.magic = kSessionChunkMagic;
+    header.record_count = static_cast<std::uint32_t>(chunk_.size());
+    header.first_timestamp = chunk_.front().timestamp;
+    header.last_timestamp = chunk_.back().timestamp;
+
+    std::fwrite(&header, sizeof(header), 1, file_);
+    std::fwrite(chunk_.data(), sizeof(SessionRecord), chunk_.size(), file_);
+
+    chunk_offsets_.push_back(offset_);
+    offset_ += sizeof(header) + sizeof(SessionRecord) * chunk_.size();
+    written_.fetch_add(chunk_.size(), std::memory_order_relaxed);
+    chunk_.clear();
+}
+
+/**
+ * \brief Appends the chunk index and trailer to the file
+ */
+void SessionRecorder::write_index()
+{
+    SessionIndexHeader index;
+    index.magic = kSessionIndexMagic;
+    index.chunk_count = static_cast<std::uint32_t>(chunk_offsets_.size());
+    std::fwrite(&index, sizeof(index), 1, file_);
+    if (!chunk_offsets_.empty())
+    {
+        std::fwrite(chunk_offsets_.data(), sizeof(std::uint64_t), chunk_offsets_.size(), file_);
+    }
+
+    SessionTrailer trailer;
+    trailer.index_offset = offset_;
+    trailer.magic = kSessionTrailerMagic;
+    trailer.reserved = 0;
+    std::fwrite(&trailer, sizeof(trailer), 1, file_);
+}
@@ -0,0 +1,59 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+#include "session_format.h"
+#include "spatial_sample.h"
+#include "spsc_ring_buffer.h"
+
+/**
+ * \brief Writes packets to a session file without ever blocking the thread that supplies them
+ *
+ * Packets are queued from the ingestion thread and written in whole chunks by a dedicated writer
+ * thread.
+ */
+class SessionRecorder
+{
+
+ public:
+
+    SessionRecorder();
+    ~SessionRecorder();
+
+    bool open(const std::string& path);
+    void close();
+
+    bool is_open() const;
+
+    void record(const SpatialSample& sample);
+
+    std::uint64_t records_written() const;
+    std::uint64_t records_dropped() const;
+
+ private:
+
+    static const std::size_t kQueueCapacity = 8192;
+
+    // Interval at which the writer thread drains the queue (milliseconds)
+    const int kFlushInterval = 20;
+
+    SpscRingBuffer<SpatialSample, kQueueCapacity> queue_;
+
+    std::FILE* file_;
+    std::thread thread_;
+    std::atomic<bool> running_;
+    std::atomic<std::uint64_t> written_;
+
+    std::vector<SessionRecord> chunk_;
+    std::vector<std::uint64_t> chunk_offsets_;
+    std::uint64_t offset_;
+
+    void run();
+    void drain();
+    void write_chunk();
+    void write_index();
+
+};
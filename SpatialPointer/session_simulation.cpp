@@ -0,0 +1,95 @@
+#include "session_simulation.h"
+#include "gyro_bias_estimator.h"
+#include "sample_block.h"
+#include <algorithm>
+
+/**
+ * \brief Runs a recorded session through the same bias correction, filtering, motion and dwell logic as the live pointer
+ * \param session recorded session
+ * \param pointer_settings motion parameters
+ * \param filter_settings filter bank parameters, the sample rate is measured from the session
+ * \param dwell_settings dwell click parameters
+ * \param screen simulated desktop, the cursor is confined to it as it is by the operating system
+ * \param output_settings cadence of the cursor moves, timed by the sensor's timestamps
+ */
+SimulationResult simulate_session(const SessionReader& session, const PointerSettings& pointer_settings, const FilterSettings& filter_settings, const DwellSettings& dwell_settings, const SimulationScreen& screen,
+                                  const OutputSettings& output_settings)
+{
+    SimulationResult result;
+
+    GyroBiasEstimator bias;
+
+    FilterSettings filter_design = filter_settings;
+    if (session.record_count() > 1 && session.duration() > 0.0)
+    {
+        filter_design.sample_rate = (session.record_count() - 1) / session.duration();
+    }
+    FilterBank filter;
+    filter.set_settings(filter_design);
+
+    PointerMotion motion;
+    motion.set_settings(pointer_settings);
+
+    DwellDetector dwell;
+    dwell.set_settings(dwell_settings);
+
+    OutputCoalescer coalescer;
+    coalescer.set_settings(output_settings);
+
+    int x = screen.width / 2;
+    int y = screen.height / 2;
+    dwell.reset(x, y, session.first_timestamp());
+    result.trajectory.push_back(TrajectoryPoint{ session.first_timestamp(), x, y });
+
+    SampleBlock block;
+    for (std::size_t c = 0; c < session.chunk_count(); ++c)
+    {
+        const SessionChunk& chunk = session.chunk(c);
+        for (std::uint32_t r = 0; r < chunk.count; r += SampleBlock::kCapacity)
+        {
+            // The bias is estimated and removed and the block filtered a block at a time, as by the live pipeline
+            block.clear();
+            for (std::uint32_t i = r; i < chunk.count && !block.full(); ++i)
+            {
+                block.push(to_spatial_sample(chunk.records[i]));
+            }
+            bias.update(block);
+            bias.correct(block);
+            filter.set_rate_noise(bias.noise());
+            filter.process(block);
+
+            // Motion is integrated a packet at a time so that the trajectory records every move, the
+            // moves are released at the output cadence
+            for (std::size_t i = 0; i < block.count; ++i)
+            {
+                const SpatialSample sample = block.sample(i);
+                motion.integrate(sample);
+
+                int displacement_x;
+                int displacement_y;
+                motion.take_pixels(displacement_x, displacement_y);
+                coalescer.add(displacement_x, displacement_y);
+                if (coalescer.due(sample.timestamp) && coalescer.flush(sample.timestamp, displacement_x, displacement_y))
+                {
+                    const int previous_x = x;
+                    const int previous_y = y;
+                    x = std::min(std::max(x + displacement_x, 0), screen.width - 1);
+                    y = std::min(std::max(y + displacement_y, 0), screen.height - 1);
+                    if (x - previous_x != displacement_x || y - previous_y != displacement_y)
+                    {
+                        coalescer.drop_lead();
+                    }
+                    result.trajectory.push_back(TrajectoryPoint{ sample.timestamp, x, y });
+                }
+
+                if (dwell.update(x, y, sample.timestamp) == DwellEvent::kClick)
+                {
+                    result.clicks.push_back(TrajectoryPoint{ sample.timestamp, x, y });
+                }
+            }
+        }
+        result.samples += chunk.count;
+    }
+
+    return result;
+}
@@ -0,0 +1,52 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "dwell_detector.h"
+#include "filter_bank.h"
+#include "output_coalescer.h"
+#include "pointer_motion.h"
+#include "session_reader.h"
+
+/**
+ * \brief Dimensions of the simulated desktop, the cursor starts at its centre
+ */
+struct SimulationScreen
+{
+
+    int width = 1920;
+    int height = 1080;
+
+};
+
+/**
+ * \brief Cursor position at a point in a session
+ */
+struct TrajectoryPoint
+{
+
+    // Hardware timestamp (seconds)
+    double timestamp;
+
+    int x;
+    int y;
+
+};
+
+/**
+ * \brief Cursor movement and dwell clicks produced by a session
+ */
+struct SimulationResult
+{
+
+    // Cursor position after every move
+    std::vector<TrajectoryPoint> trajectory;
+
+    // Cursor position of every dwell click
+    std::vector<TrajectoryPoint> clicks;
+
+    std::uint64_t samples = 0;
+
+};
+
+SimulationResult simulate_session(const SessionReader& session, const PointerSettings& pointer_settings, const FilterSettings& filter_settings, const DwellSettings& dwell_settings, const SimulationScreen& screen,
+                                  const OutputSettings& output_settings);
@@ -0,0 +1,14 @@
+#pragma once
+
+// Instruction sets available to the vectorized kernels, as targeted by the compiler (e.g. -mavx or
+// /arch:AVX). SSE2 is part of every x86-64 target.
+
+#if defined(__AVX__)
+#define POINTY_AVX
+#include <immintrin.h>
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define POINTY_SSE2
+#include <emmintrin.h>
+#endif
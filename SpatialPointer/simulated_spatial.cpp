@@ -0,0 +1,118 @@
+#include "simulated_spatial.h"
+#include "phidget_spatial.h"
+#include <chrono>
+#include <cmath>
+#include <random>
+
+SimulatedSpatial::SimulatedSpatial(const SimulationSettings& settings) : settings_(settings), running_(false)
+{
+    if (settings_.rate <= 0.0)
+    {
+        settings_.rate = 1.0;
+    }
+    if (settings_.burst < 1)
+    {
+        settings_.burst = 1;
+    }
+    else if (settings_.burst > kMaxBurst)
+    {
+        settings_.burst = kMaxBurst;
+    }
+}
+
+SimulatedSpatial::~SimulatedSpatial()
+{
+    close();
+}
+
+/**
+ * \brief Starts generating packets on a dedicated thread
+ * \param spatial receiver of the packets
+ */
+bool SimulatedSpatial::open(PhidgetSpatial* spatial)
+{
+    close();
+
+    running_ = true;
+    thread_ = std::thread(&SimulatedSpatial::run, this, spatial);
+    return true;
+}
+
+/**
+ * \brief Stops generating packets and waits for the generator thread to finish
+ */
+void SimulatedSpatial::close()
+{
+    running_ = false;
+    if (thread_.joinable())
+    {
+        thread_.join();
+    }
+}
+
+/**
+ * \brief Returns the configured packet rate, the timestamps advance by its period
+ */
+double SimulatedSpatial::sample_rate() const
+{
+    return settings_.rate;
+}
+
+/**
+ * \brief Generator thread, delivers bursts of packets on the configured schedule
+ * \param spatial receiver of the packets
+ */
+void SimulatedSpatial::run(PhidgetSpatial* spatial)
+{
+    const double kTwoPi = 6.283185307179586;
+
+    std::mt19937 generator(settings_.seed);
+    std::normal_distribution<double> gyro_noise(0.0, settings_.gyro_noise);
+    std::normal_distribution<double> acceleration_noise(0.0, settings_.acceleration_noise);
+    std::normal_distribution<double> magnetic_noise(0.0, settings_.magnetic_noise);
+
+    CPhidgetSpatial_SpatialEventData packets[kMaxBurst];
+    CPhidgetSpatial_SpatialEventDataHandle handles[kMaxBurst];
+    for (int i = 0; i < kMaxBurst; ++i)
+    {
+        handles[i] = &packets[i];
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const double interval = 1.0 / settings_.rate;
+    std::uint64_t index = 0;
+
+    while (running_)
+    {
+        for (int i = 0; i < settings_.burst; ++i, ++index)
+        {
+            const double time = index * interval;
+            const double phase = kTwoPi * settings_.frequency * time;
+
+            CPhidgetSpatial_SpatialEventData& packet = packets[i];
+            packet.angularRate[0] = settings_.amplitude * std::cos(phase) + settings_.gyro_bias.x + gyro_noise(generator);
+            packet.angularRate[1] = settings_.gyro_bias.y + gyro_noise(generator);
+            packet.angularRate[2] = settings_.amplitude * std::sin(phase) + settings_.gyro_bias.z + gyro_noise(generator);
+
+            // At rest under gravity with a fixed ambient field
+            packet.acceleration[0] = acceleration_noise(generator);
+            packet.acceleration[1] = acceleration_noise(generator);
+            packet.acceleration[2] = -1.0 + acceleration_noise(generator);
+            packet.magneticField[0] = 0.2 + magnetic_noise(generator);
+            packet.magneticField[1] = magnetic_noise(generator);
+            packet.magneticField[2] = -0.4 + magnetic_noise(generator);
+
+            packet.timestamp.seconds = static_cast<int>(time);
+            packet.timestamp.microseconds = static_cast<int>((time - packet.timestamp.seconds) * 1000000.0);
+        }
+
+        // Deliver the burst once its final packet would have been measured
+        if (settings_.realtime)
+        {
+            const auto due = start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(index * interval));
+            std::this_thread::sleep_until(due);
+        }
+
+        spatial->inject_packets(handles, settings_.burst);
+    }
+}
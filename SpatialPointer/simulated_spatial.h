@@ -0,0 +1,66 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <thread>
+#include "spatial_source.h"
+#include "linear_algebra.h"
+
+/**
+ * \brief Parameters of the synthetic packet stream
+ */
+struct SimulationSettings
+{
+
+    // Packets per second, not limited to the hardware's range
+    double rate = 125.0;
+
+    // Packets delivered per callback, mimics bursty USB delivery
+    int burst = 1;
+
+    // When false packets are delivered as fast as possible
+    bool realtime = true;
+
+    // Standard deviation of the noise added to every channel (deg/s, g and gauss respectively)
+    double gyro_noise = 0.05;
+    double acceleration_noise = 0.002;
+    double magnetic_noise = 0.001;
+
+    // Constant offset added to the angular rate (deg/s)
+    Vec3d gyro_bias;
+
+    // Synthetic head motion, a slow circular sweep (peak deg/s and Hz)
+    double amplitude = 30.0;
+    double frequency = 0.25;
+
+    unsigned int seed = 1;
+
+};
+
+/**
+ * \brief Source of synthetic Phidget Spatial 3/3/3 packets for benchmarking without hardware
+ */
+class SimulatedSpatial : public SpatialSource
+{
+
+ public:
+
+    explicit SimulatedSpatial(const SimulationSettings& settings);
+    ~SimulatedSpatial();
+
+    bool open(PhidgetSpatial* spatial) override;
+    void close() override;
+
+    double sample_rate() const override;
+
+ private:
+
+    static const int kMaxBurst = 256;
+
+    SimulationSettings settings_;
+
+    std::thread thread_;
+    std::atomic<bool> running_;
+
+    void run(PhidgetSpatial* spatial);
+
+};
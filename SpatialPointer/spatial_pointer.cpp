@@ -1,30 +1,44 @@
 #include "spatial_pointer.h"
 #include "ui_spatial_pointer.h"
+#include "curve_dialog.h"
 #include "phidget_spatial.h"
+#include "pointer_pipeline.h"
 #include <QTimer>
 #include <QCursor>
 #include <QDesktopServices>
 #include <QDesktopWidget>
+#include <QFileDialog>
+#include <QScreen>
+#include <QSettings>
+#include <QtMath>
 #include <Qurl>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
 
 /**
  * @brief Initialize
+ * @param output destination of the cursor movement and clicks
  * @param parent parent widget
  */
-SpatialPointer::SpatialPointer(QWidget *parent) : QWidget(parent), ui(new Ui::SpatialPointer)
+SpatialPointer::SpatialPointer(CursorOutput* output, QWidget *parent) : QWidget(parent), ui(new Ui::SpatialPointer)
 {
     ui->setupUi(this);
 
     // Obtain a reference to the PhidgetSpatial singleton
     spatial_ = PhidgetSpatial::instance();
 
-    // Initialize and connect the update timer to the update function
-    tmr_update = new QTimer(this);
-    connect(tmr_update, SIGNAL(timeout()), this, SLOT(slot_update()));
+    // Initialize and connect the pointer pipeline, cursor movement is handled on its own thread
+    pipeline_ = new PointerPipeline(spatial_, output, this);
+    connect(pipeline_, SIGNAL(cursor_moved(QPoint)), this, SLOT(slot_cursor_moved(QPoint)));
+    connect(pipeline_, SIGNAL(dwell_armed(QPoint)), this, SLOT(slot_dwell_armed(QPoint)));
+    connect(pipeline_, SIGNAL(dwell_cancelled()), this, SLOT(slot_dwell_cancelled()));
+    connect(pipeline_, SIGNAL(detached()), this, SLOT(slot_detached()));
 
-    // Initialize and connect the update timer to the update function
-    tmr_activate_click = new QTimer(this);
-    connect(tmr_activate_click, SIGNAL(timeout()), this, SLOT(slot_activate_click()));
+    // Initialize and connect the diagnostics timer to the diagnostics update function
+    tmr_diagnostics = new QTimer(this);
+    connect(tmr_diagnostics, SIGNAL(timeout()), this, SLOT(slot_update_diagnostics()));
+    tmr_diagnostics->start(kDiagnosticsUpdateRate);
 
     // Initialize the tolerance value and respective controls to their default values
     tolerance_ = ui->sld_deadzone->value();
@@ -34,6 +48,11 @@ SpatialPointer::SpatialPointer(QWidget *parent) : QWidget(parent), ui(new Ui::Sp
     speed_ = ui->sld_speed->value();
     ui->lbl_speed_value->setText(QString::number(ui->sld_speed->value()));
 
+    // Initialize the smoothing values and respective controls to their default values
+    min_cutoff_ = ui->sld_min_cutoff->value();
+    beta_ = ui->sld_beta->value();
+    update_smoothing_label();
+
     // Initialize the radius value and respective controls to their default values
     radius_ = ui->sld_trigger_radius->value();
     ui->lbl_trigger_radius_value->setText(QString::number(ui->sld_trigger_radius->value()) + "px");
@@ -51,15 +70,43 @@ SpatialPointer::SpatialPointer(QWidget *parent) : QWidget(parent), ui(new Ui::Sp
     vertical_ = ui->chk_vertical->isChecked();
     invert_ = ui->chk_invert->isChecked();
     clicking_enabled_ = ui->chk_clicking_enabled->isChecked();
+    absolute_ = ui->chk_absolute->isChecked();
+    look_ahead_ = ui->spn_look_ahead->value();
+
+    // Restore the acceleration curve of the profile selected last time
+    load_profiles();
+
+    pipeline_->set_settings(pointer_settings());
+    pipeline_->set_dwell_settings(dwell_settings());
+    pipeline_->set_absolute_settings(absolute_settings());
+
+    filter_.type = static_cast<FilterType>(ui->cmb_filter->currentIndex());
+    filter_.tremor_notch = ui->chk_tremor->isChecked();
+    update_filter_controls();
+    pipeline_->set_filter_settings(filter_);
+
+    // Absolute pointing and the tracked cursor position span every monitor, follow changes to the
+    // desktop's layout and refresh rate rather than querying them as the cursor moves
+    connect(qApp, SIGNAL(screenAdded(QScreen*)), this, SLOT(slot_screen_added(QScreen*)));
+    connect(qApp, SIGNAL(screenRemoved(QScreen*)), this, SLOT(slot_desktop_changed()));
+    for(QScreen* screen : QGuiApplication::screens())
+    {
+        connect(screen, SIGNAL(geometryChanged(QRect)), this, SLOT(slot_desktop_changed()));
+        connect(screen, SIGNAL(refreshRateChanged(qreal)), this, SLOT(slot_desktop_changed()));
+    }
+    desktop_ = desktop_layout();
+    pipeline_->set_desktop_layout(desktop_);
+
+    // Move the cursor as soon as packets have been processed until told otherwise
+    follow_refresh_ = false;
+    pipeline_->set_output_settings(output_);
 
     // Set the status to idle
     enabled_ = false;
     //set_status(kStatusIdle);
 
-    overlay_ = new Overlay();
+    overlay_ = new Overlay(output);
     overlay_->hide();
-
-    old_mouse_position = QCursor::pos();
 }
 
 /**
@@ -67,71 +114,127 @@ SpatialPointer::SpatialPointer(QWidget *parent) : QWidget(parent), ui(new Ui::Sp
  */
 SpatialPointer::~SpatialPointer()
 {
-    delete tmr_update;
+    pipeline_->stop();
     delete ui;
 }
 
 /**
- * @brief Moves the mouse cursor using the angular data of the Phidget Spatial
+ * @brief Sets the cadence of the cursor moves
+ * @param settings new parameters
+ * @param follow_refresh move the cursor once per refresh of the fastest monitor instead of at the settings' rate
  */
-void SpatialPointer::slot_update()
+void SpatialPointer::set_output_settings(const OutputSettings& settings, const bool& follow_refresh)
 {
-    // Phidget Spatial was detatched, disable and set the status message to failure
-    if(!spatial_->attatched())
-    {
-        set_enabled(false);
-            show_message_box("The Phidget Spatial 3/3/3 sensor was disconnected and Pointy has been disabled.", QWidget::windowTitle(), QMessageBox::Warning);
-    }
+    output_ = settings;
+    follow_refresh_ = follow_refresh;
+    if(follow_refresh_)
+        output_.rate = refresh_rate();
+    pipeline_->set_output_settings(output_);
+}
 
-    // Pointer was disabled, return
-    if(!enabled_)
+/**
+ * @brief Keeps the overlay alongside the cursor during the click countdown
+ * @param position new cursor position
+ */
+void SpatialPointer::slot_cursor_moved(const QPoint& position)
+{
+    if(enabled_ && !overlay_->isHidden())
+        move_overlay(position);
+}
+
+/**
+ * @brief The cursor has dwelled for the trigger time, show the overlay and begin the click countdown
+ * @param position cursor position
+ */
+void SpatialPointer::slot_dwell_armed(const QPoint& position)
+{
+    if(!enabled_ || !clicking_enabled_)
         return;
 
-    // Obtain the angular rate data from the Phidget Spatial
-    auto angular_rate = spatial_->angular_rate();
+    move_overlay(position);
+    overlay_->set_enabled(true, click_time_);
+}
 
-    // If the angular data on either axis exceeds the tolerance then set the respective velocity
-    int velocity_x = (horizontal_ && (angular_rate.z > tolerance_ || angular_rate.z < -tolerance_)) ? (invert_ ? -angular_rate.z : angular_rate.z) * speed_ : 0;
-    int velocity_y = (vertical_ & (angular_rate.x > tolerance_ || angular_rate.x < -tolerance_)) ? (invert_ ? -angular_rate.x : angular_rate.x) * speed_ : 0;
+/**
+ * @brief The cursor left the trigger radius, cancel the click countdown
+ */
+void SpatialPointer::slot_dwell_cancelled()
+{
+    overlay_->set_enabled(false, click_time_);
+}
 
-    // Move the cursor
-    move_cursor(velocity_x, velocity_y);
+/**
+ * @brief Phidget Spatial was detatched, disable and notify the user
+ */
+void SpatialPointer::slot_detached()
+{
+    set_enabled(false);
+    show_message_box("The Phidget Spatial 3/3/3 sensor was disconnected and Pointy has been disabled.", QWidget::windowTitle(), QMessageBox::Warning);
+}
 
-    if(!clicking_enabled_)
+/**
+ * @brief Refreshes the diagnostics tab
+ */
+void SpatialPointer::slot_update_diagnostics()
+{
+    if(!ui->tab_diagnostics->isVisible())
         return;
 
-    QPoint mouse_position = QCursor::pos();
-    QRect resolution = QApplication::desktop()->screenGeometry();
-
-    QPoint overlay_position = mouse_position;
-    QSize overlay_size = overlay_->size();
-
-    // If the mouse is in such a position that the overlay would not be visible, adjust the overlay position.
-    if(mouse_position.x() > resolution.width() - overlay_size.width())
-        overlay_position.setX(overlay_position.x() - overlay_size.width());
-    if(mouse_position.y() > resolution.height() - overlay_size.height())
-        overlay_position.setY(overlay_position.y() - overlay_size.height());
+    QString text;
+    text += "Pending packets: " + QString::number(spatial_->pending_samples()) + "\n";
+    text += "Dropped packets: " + QString::number(spatial_->dropped_samples()) + "\n";
+    PipelineStatus status = pipeline_->status();
+    text += "Sub-pixel residual: " + QString::number(status.residual_x, 'f', 3) + ", " + QString::number(status.residual_y, 'f', 3) + " px\n";
+    text += "Orientation (yaw / pitch / roll): " + QString::number(qRadiansToDegrees(status.orientation.yaw()), 'f', 1) + " / "
+            + QString::number(qRadiansToDegrees(status.orientation.pitch()), 'f', 1) + " / "
+            + QString::number(qRadiansToDegrees(status.orientation.roll()), 'f', 1) + " deg\n";
+    text += "Gyro bias: " + QString::number(status.gyro_bias.x, 'f', 2) + ", " + QString::number(status.gyro_bias.y, 'f', 2) + ", "
+            + QString::number(status.gyro_bias.z, 'f', 2) + " deg/s" + (status.still ? " (still)" : "") + "\n";
+    text += "Gyro noise: " + QString::number(qSqrt(status.gyro_noise.x), 'f', 2) + ", " + QString::number(qSqrt(status.gyro_noise.y), 'f', 2) + ", "
+            + QString::number(qSqrt(status.gyro_noise.z), 'f', 2) + " deg/s\n";
+    if(status.tremor)
+        text += "Tremor: " + QString::number(status.tremor_frequency, 'f', 1) + " Hz (" + QString::number(status.tremor_amplitude, 'f', 1) + " deg/s)\n";
+    else
+        text += "Tremor: none\n";
+    text += "Cursor resyncs: " + QString::number(status.cursor_resyncs) + "\n";
+    text += "Cursor moves: " + QString::number(status.moves_emitted) + " for " + QString::number(status.samples_consumed) + " packets";
+    if(output_.rate > 0.0)
+        text += " (at most " + QString::number(output_.rate, 'f', 0) + " per second)";
+    text += "\n";
+    text += "Latency (p50 / p99 / p99.9 / max)\n";
+    text += "Queued: " + format_latency(pipeline_->queue_latency()) + "\n";
+    text += "Processing: " + format_latency(pipeline_->processing_latency()) + "\n";
+    text += "Packet to cursor: " + format_latency(pipeline_->end_to_end_latency()) + "\n";
+    text += "Filter per packet: " + format_latency(pipeline_->filter_cost()) + "\n";
+    text += "Fusion per packet: " + format_latency(pipeline_->fusion_cost()) + "\n";
+    ui->lbl_diagnostics->setText(text);
+}
 
-    overlay_->move(overlay_position);
+/**
+ * @brief Monitors added, removed, resized or refresh rate changed event
+ */
+void SpatialPointer::slot_desktop_changed()
+{
+    desktop_ = desktop_layout();
+    pipeline_->set_desktop_layout(desktop_);
+    pipeline_->set_absolute_settings(absolute_settings());
 
-    if(abs_difference(old_mouse_position.x(), mouse_position.x()) < radius_ && abs_difference(old_mouse_position.y(), mouse_position.y() < radius_))
+    if(follow_refresh_)
     {
-        if(!tmr_activate_click->isActive() && overlay_->isHidden())
-            tmr_activate_click->start(trigger_time_);
+        output_.rate = refresh_rate();
+        pipeline_->set_output_settings(output_);
     }
-    else
-    {
-        old_mouse_position = mouse_position;
-        overlay_->set_enabled(false, click_time_);
-        tmr_activate_click->stop();
-    }
-
 }
 
-void SpatialPointer::slot_activate_click()
+/**
+ * @brief Monitor added event, follows its geometry and refresh rate from now on
+ * @param screen new monitor
+ */
+void SpatialPointer::slot_screen_added(QScreen* screen)
 {
-    overlay_->set_enabled(true, click_time_);
-    tmr_activate_click->stop();
+    connect(screen, SIGNAL(geometryChanged(QRect)), this, SLOT(slot_desktop_changed()));
+    connect(screen, SIGNAL(refreshRateChanged(qreal)), this, SLOT(slot_desktop_changed()));
+    slot_desktop_changed();
 }
 
 /**
@@ -141,26 +244,160 @@ void SpatialPointer::slot_activate_click()
 void SpatialPointer::set_enabled(const bool &state)
 {
     enabled_ = state;
-    enabled_ ? tmr_update->start(kUpdateRate) : tmr_update->stop();
+    enabled_ ? pipeline_->start(QThread::TimeCriticalPriority) : pipeline_->stop();
     if(!enabled_)
-    {
-        tmr_activate_click->stop();
         overlay_->set_enabled(false, click_time_);
-    }
 
     ui->btn_enable->setEnabled(state == false);
     ui->btn_disable->setEnabled(state == true);
 }
 
 /**
- * \brief Move the mouse cursor relative to its current position
- * \param x x velocity
- * \param x y velocity
-*/
-void SpatialPointer::move_cursor(const int &x, const int &y)
+ * @brief Returns the pointer motion parameters selected by the form controls
+ */
+PointerSettings SpatialPointer::pointer_settings() const
 {
-    QPoint cursor_position = QCursor::pos();
-    QCursor::setPos(cursor_position.x() + x, cursor_position.y() + y);
+    const double kMillisecondsPerSecond = 1000.0;
+
+    PointerSettings settings;
+    settings.tolerance = tolerance_;
+    settings.speed = speed_;
+    settings.horizontal = horizontal_;
+    settings.vertical = vertical_;
+    settings.invert = invert_;
+    settings.min_cutoff = min_cutoff_ * kMinCutoffStep;
+    settings.beta = beta_ * kBetaStep;
+    settings.ballistics = ballistics_;
+    settings.look_ahead = look_ahead_ / kMillisecondsPerSecond;
+    return settings;
+}
+
+/**
+ * @brief Returns the dwell click parameters selected by the form controls
+ */
+DwellSettings SpatialPointer::dwell_settings() const
+{
+    const double kMillisecondsPerSecond = 1000.0;
+
+    DwellSettings settings;
+    settings.enabled = clicking_enabled_;
+    settings.radius = radius_;
+    settings.trigger_time = trigger_time_ / kMillisecondsPerSecond;
+    settings.click_time = click_time_;
+    return settings;
+}
+
+/**
+ * @brief Returns the absolute pointing parameters selected by the form controls and the bounds of
+ * the virtual desktop
+ */
+AbsoluteSettings SpatialPointer::absolute_settings() const
+{
+    const QRect geometry = QGuiApplication::primaryScreen()->virtualGeometry();
+
+    AbsoluteSettings settings;
+    settings.enabled = absolute_;
+    settings.range = kAbsoluteRange / speed_;
+    settings.desktop.x = geometry.x();
+    settings.desktop.y = geometry.y();
+    settings.desktop.width = geometry.width();
+    settings.desktop.height = geometry.height();
+    return settings;
+}
+
+/**
+ * @brief Returns the arrangement of the monitors
+ */
+DesktopLayout SpatialPointer::desktop_layout() const
+{
+    DesktopLayout layout;
+    for(QScreen* screen : QGuiApplication::screens())
+    {
+        if(layout.screen_count == DesktopLayout::kMaxScreens)
+            break;
+
+        const QRect geometry = screen->geometry();
+        ScreenRect& rect = layout.screens[layout.screen_count++];
+        rect.x = geometry.x();
+        rect.y = geometry.y();
+        rect.width = geometry.width();
+        rect.height = geometry.height();
+    }
+    return layout;
+}
+
+/**
+ * @brief Returns the refresh rate of the fastest monitor (hertz), moving the cursor more often than that is never seen
+ */
+double SpatialPointer::refresh_rate() const
+{
+    double rate = 0.0;
+    for(QScreen* screen : QGuiApplication::screens())
+        rate = std::max(rate, static_cast<double>(screen->refreshRate()));
+
+    // Without a monitor that reports it, assume the most common refresh rate
+    return rate > 0.0 ? rate : kDefaultRefreshRate;
+}
+
+/**
+ * @brief Shows the parameter of the selected filter in the filter controls
+ */
+void SpatialPointer::update_filter_controls()
+{
+    // Block the spin box's signal while it is repurposed, it would otherwise overwrite the parameter
+    const bool blocked = ui->spn_filter_frequency->blockSignals(true);
+
+    switch(filter_.type)
+    {
+    case FilterType::kLowPass:
+    case FilterType::kNotch:
+    case FilterType::kKalman:
+        ui->spn_filter_frequency->setRange(1, 60);
+        ui->spn_filter_frequency->setSuffix(" Hz");
+        ui->spn_filter_frequency->setValue(qRound(filter_.frequency));
+        break;
+    case FilterType::kMovingAverage:
+        ui->spn_filter_frequency->setRange(2, FilterSettings::kMaxTaps);
+        ui->spn_filter_frequency->setSuffix(" packets");
+        ui->spn_filter_frequency->setValue(filter_.length);
+        break;
+    default:
+        break;
+    }
+
+    ui->spn_filter_frequency->blockSignals(blocked);
+
+    ui->spn_filter_frequency->setEnabled(filter_.type == FilterType::kLowPass || filter_.type == FilterType::kNotch || filter_.type == FilterType::kMovingAverage
+                                         || filter_.type == FilterType::kKalman);
+    ui->btn_filter_taps->setEnabled(filter_.type == FilterType::kFir);
+}
+
+/**
+ * @brief Moves the overlay next to the cursor, keeping it on screen
+ * @param position cursor position
+ */
+void SpatialPointer::move_overlay(const QPoint& position)
+{
+    // The monitor the cursor is on, from the cached layout
+    QRect resolution;
+    for(int i = 0; i < desktop_.screen_count; ++i)
+    {
+        const ScreenRect& screen = desktop_.screens[i];
+        const QRect geometry(screen.x, screen.y, screen.width, screen.height);
+        if(i == 0 || geometry.contains(position))
+            resolution = geometry;
+    }
+
+    QPoint overlay_position = position;
+    QSize overlay_size = overlay_->size();
+
+    // If the mouse is in such a position that the overlay would not be visible, adjust the overlay position.
+    if(position.x() > resolution.right() + 1 - overlay_size.width())
+        overlay_position.setX(overlay_position.x() - overlay_size.width());
+    if(position.y() > resolution.bottom() + 1 - overlay_size.height())
+        overlay_position.setY(overlay_position.y() - overlay_size.height());
+
+    overlay_->move(overlay_position);
 }
 
 /**
@@ -193,6 +430,7 @@ void SpatialPointer::on_btn_disable_clicked()
 void SpatialPointer::on_sld_deadzone_valueChanged(int value)
 {
     tolerance_= value;
+    pipeline_->set_settings(pointer_settings());
     ui->lbl_deadzone_value->setText(QString::number(value));
 }
 
@@ -203,9 +441,111 @@ void SpatialPointer::on_sld_deadzone_valueChanged(int value)
 void SpatialPointer::on_sld_speed_valueChanged(int value)
 {
     speed_ = value;
+    pipeline_->set_settings(pointer_settings());
+    pipeline_->set_absolute_settings(absolute_settings());
     ui->lbl_speed_value->setText(QString::number(value));
 }
 
+/**
+ * @brief Minimum cut-off slider value changed event
+ * @param value new value
+ */
+void SpatialPointer::on_sld_min_cutoff_valueChanged(int value)
+{
+    min_cutoff_ = value;
+    pipeline_->set_settings(pointer_settings());
+    update_smoothing_label();
+}
+
+/**
+ * @brief Beta slider value changed event
+ * @param value new value
+ */
+void SpatialPointer::on_sld_beta_valueChanged(int value)
+{
+    beta_ = value;
+    pipeline_->set_settings(pointer_settings());
+}
+
+/**
+ * @brief Shows the minimum cut-off, or that smoothing is off
+ */
+void SpatialPointer::update_smoothing_label()
+{
+    ui->lbl_smoothing_value->setText(min_cutoff_ > 0 ? QString::number(min_cutoff_ * kMinCutoffStep, 'f', 1) + "Hz" : "Off");
+    ui->sld_beta->setEnabled(min_cutoff_ > 0);
+}
+
+/**
+ * @brief Shows whether the selected profile accelerates the pointer
+ */
+void SpatialPointer::update_acceleration_label()
+{
+    ui->lbl_acceleration_value->setText(ballistics_.point_count > 0 ? "On" : "Off");
+}
+
+/**
+ * @brief Lists the stored profiles and loads the one selected last time
+ */
+void SpatialPointer::load_profiles()
+{
+    QSettings settings;
+    settings.beginGroup("profiles");
+    QStringList names = settings.childGroups();
+    settings.endGroup();
+    if(!names.contains(kDefaultProfile))
+        names.append(kDefaultProfile);
+    names.sort(Qt::CaseInsensitive);
+
+    QString name = settings.value("profile", kDefaultProfile).toString();
+    if(!names.contains(name))
+        name = kDefaultProfile;
+
+    // Block the combo box's signal while it is filled, it would otherwise load every profile in turn
+    const bool blocked = ui->cmb_profile->blockSignals(true);
+    ui->cmb_profile->clear();
+    ui->cmb_profile->addItems(names);
+    ui->cmb_profile->setCurrentIndex(names.indexOf(name));
+    ui->cmb_profile->blockSignals(blocked);
+
+    profile_ = name;
+    load_profile(profile_);
+    update_acceleration_label();
+}
+
+/**
+ * @brief Reads a profile's acceleration curve into ballistics_
+ * @param name profile name
+ * @return whether the profile had been stored
+ */
+bool SpatialPointer::load_profile(const QString& name)
+{
+    QSettings settings;
+    settings.beginGroup("profiles/" + name);
+    if(!settings.contains("curve"))
+        return false;
+
+    BallisticsSettings ballistics;
+    ballistics.shape = settings.value("shape").toString() == "linear" ? CurveShape::kLinear : CurveShape::kSmooth;
+    if(!parse_curve(settings.value("curve").toString().toStdString(), ballistics))
+        qWarning("Ignoring the malformed acceleration curve of profile %s", qPrintable(name));
+
+    ballistics_ = ballistics;
+    return true;
+}
+
+/**
+ * @brief Stores the acceleration curve under the selected profile and remembers the selection
+ */
+void SpatialPointer::save_profile() const
+{
+    QSettings settings;
+    settings.setValue("profile", profile_);
+    settings.beginGroup("profiles/" + profile_);
+    settings.setValue("shape", ballistics_.shape == CurveShape::kLinear ? "linear" : "smooth");
+    settings.setValue("curve", QString::fromStdString(format_curve(ballistics_)));
+}
+
 /**
  * @brief Horizontal checkbox state changed event
  * @param arg1 new state
@@ -213,6 +553,7 @@ void SpatialPointer::on_sld_speed_valueChanged(int value)
 void SpatialPointer::on_chk_horizontal_stateChanged(int arg1)
 {
     horizontal_ = arg1;
+    pipeline_->set_settings(pointer_settings());
 }
 
 /**
@@ -222,6 +563,7 @@ void SpatialPointer::on_chk_horizontal_stateChanged(int arg1)
 void SpatialPointer::on_chk_vertical_stateChanged(int arg1)
 {
     vertical_ = arg1;
+    pipeline_->set_settings(pointer_settings());
 }
 
 /**
@@ -231,6 +573,7 @@ void SpatialPointer::on_chk_vertical_stateChanged(int arg1)
 void SpatialPointer::on_chk_invert_toggled(bool checked)
 {
     invert_ = checked;
+    pipeline_->set_settings(pointer_settings());
 }
 
 /**
@@ -240,6 +583,7 @@ void SpatialPointer::on_chk_invert_toggled(bool checked)
 void SpatialPointer::on_sld_trigger_radius_valueChanged(int value)
 {
     radius_ = value;
+    pipeline_->set_dwell_settings(dwell_settings());
     ui->lbl_trigger_radius_value->setText(QString::number(radius_) + "px");
 }
 
@@ -250,6 +594,7 @@ void SpatialPointer::on_sld_trigger_radius_valueChanged(int value)
 void SpatialPointer::on_sld_trigger_time_valueChanged(int value)
 {
     trigger_time_ = value;
+    pipeline_->set_dwell_settings(dwell_settings());
     ui->lbl_trigger_time_value->setText(QString::number(trigger_time_) + "ms");
 }
 
@@ -260,17 +605,148 @@ void SpatialPointer::on_sld_trigger_time_valueChanged(int value)
 void SpatialPointer::on_sld_click_time_valueChanged(int value)
 {
     click_time_ = value;
+    pipeline_->set_dwell_settings(dwell_settings());
     ui->lbl_click_time_value->setText(QString::number(click_time_) + "s");
 }
 
-int SpatialPointer::abs_difference(const int &x, const int &y)
+void SpatialPointer::on_chk_clicking_enabled_toggled(bool checked)
+{
+    clicking_enabled_ = checked;
+    pipeline_->set_dwell_settings(dwell_settings());
+
+    if(!clicking_enabled_)
+        overlay_->set_enabled(false, click_time_);
+}
+
+/**
+ * @brief Absolute checkbox toggled event
+ * @param checked new state
+ */
+void SpatialPointer::on_chk_absolute_toggled(bool checked)
 {
-    return static_cast<int>(abs(x - y));
+    absolute_ = checked;
+    pipeline_->set_absolute_settings(absolute_settings());
 }
 
-void SpatialPointer::on_chk_clicking_enabled_toggled(bool checked)
+/**
+ * @brief Filter combo box index changed event
+ * @param index new index
+ */
+void SpatialPointer::on_cmb_filter_currentIndexChanged(int index)
 {
-    clicking_enabled_ = checked;
+    filter_.type = static_cast<FilterType>(index);
+    update_filter_controls();
+    pipeline_->set_filter_settings(filter_);
+}
+
+/**
+ * @brief Filter parameter spin box value changed event
+ * @param value new value
+ */
+void SpatialPointer::on_spn_filter_frequency_valueChanged(int value)
+{
+    if(filter_.type == FilterType::kMovingAverage)
+        filter_.length = value;
+    else
+        filter_.frequency = value;
+    pipeline_->set_filter_settings(filter_);
+}
+
+/**
+ * @brief Filter taps button clicked event, loads the FIR filter's taps from a text file of numbers
+ */
+void SpatialPointer::on_btn_filter_taps_clicked()
+{
+    QString path = QFileDialog::getOpenFileName(this, "Load filter taps", QString(), "Text files (*.txt *.csv);;All files (*)");
+    if(path.isEmpty())
+        return;
+
+    std::ifstream stream(path.toLocal8Bit().constData());
+    FilterSettings filter = filter_;
+    filter.tap_count = 0;
+
+    // Taps may be separated by whitespace or commas
+    std::string token;
+    while(stream >> token)
+    {
+        std::replace(token.begin(), token.end(), ',', ' ');
+        std::istringstream values(token);
+        float tap;
+        while(values >> tap)
+        {
+            if(filter.tap_count == FilterSettings::kMaxTaps)
+            {
+                show_message_box("FIR filters are limited to " + QString::number(FilterSettings::kMaxTaps) + " taps.", QWidget::windowTitle(), QMessageBox::Warning);
+                return;
+            }
+            filter.taps[filter.tap_count++] = tap;
+        }
+    }
+
+    if(filter.tap_count == 0)
+    {
+        show_message_box("No filter taps could be read from " + path + ".", QWidget::windowTitle(), QMessageBox::Warning);
+        return;
+    }
+
+    filter_ = filter;
+    pipeline_->set_filter_settings(filter_);
+}
+
+/**
+ * @brief Profile combo box index changed event, loads the profile or creates it from the current curve
+ * @param index new index
+ */
+void SpatialPointer::on_cmb_profile_currentIndexChanged(int index)
+{
+    // QSettings treats slashes as groups, they cannot be part of a name
+    const QString name = ui->cmb_profile->itemText(index).trimmed().replace('/', '-').replace('\\', '-');
+    if(index < 0 || name.isEmpty() || name == profile_)
+        return;
+
+    profile_ = name;
+    if(!load_profile(profile_))
+        save_profile();
+    else
+        QSettings().setValue("profile", profile_);
+
+    update_acceleration_label();
+    pipeline_->set_settings(pointer_settings());
+}
+
+/**
+ * @brief Acceleration curve button clicked event, edits the selected profile's curve
+ */
+void SpatialPointer::on_btn_acceleration_curve_clicked()
+{
+    CurveDialog dialog(ballistics_, this);
+    if(dialog.exec() != QDialog::Accepted)
+        return;
+
+    ballistics_ = dialog.settings();
+    save_profile();
+    update_acceleration_label();
+    pipeline_->set_settings(pointer_settings());
+}
+
+/**
+ * @brief Tremor notch checkbox toggled event
+ * @param checked new state
+ */
+void SpatialPointer::on_chk_tremor_toggled(bool checked)
+{
+    filter_.tremor_notch = checked;
+    pipeline_->set_filter_settings(filter_);
+}
+
+/**
+ * @brief Look-ahead spin box changed event
+ * @param value new look-ahead (milliseconds)
+ */
+void SpatialPointer::on_spn_look_ahead_valueChanged(int value)
+{
+    look_ahead_ = value;
+    pipeline_->set_settings(pointer_settings());
 }
 
 void SpatialPointer::show_message_box(const QString &message, const QString &caption, const QMessageBox::Icon &icon)
@@ -281,3 +757,47 @@ void SpatialPointer::show_message_box(const QString &message, const QString &cap
     message_box.setIcon(icon);
     message_box.exec();
 }
+
+/**
+ * @brief Save latency report button clicked event
+ */
+void SpatialPointer::on_btn_save_latency_clicked()
+{
+    QString path = QFileDialog::getSaveFileName(this, "Save latency report", "latency.txt", "Text files (*.txt)");
+    if(path.isEmpty())
+        return;
+
+    std::ofstream stream(path.toLocal8Bit().constData());
+    if(!stream)
+    {
+        show_message_box("The latency report could not be saved to " + path + ".", QWidget::windowTitle(), QMessageBox::Warning);
+        return;
+    }
+
+    pipeline_->queue_latency().write(stream, "queued (ns)");
+    pipeline_->processing_latency().write(stream, "processing (ns)");
+    pipeline_->end_to_end_latency().write(stream, "packet to cursor (ns)");
+    pipeline_->filter_cost().write(stream, "filter per packet (ns)");
+    pipeline_->fusion_cost().write(stream, "fusion per packet (ns)");
+}
+
+/**
+ * @brief Reset latency button clicked event
+ */
+void SpatialPointer::on_btn_reset_latency_clicked()
+{
+    pipeline_->reset_latency();
+}
+
+/**
+ * @brief Formats the percentiles of a latency histogram in microseconds
+ * @param histogram histogram to format
+ */
+QString SpatialPointer::format_latency(const LatencyHistogram& histogram)
+{
+    const double kNanosecondsPerMicrosecond = 1000.0;
+    return QString::number(histogram.percentile(50.0) / kNanosecondsPerMicrosecond, 'f', 1) + " / "
+            + QString::number(histogram.percentile(99.0) / kNanosecondsPerMicrosecond, 'f', 1) + " / "
+            + QString::number(histogram.percentile(99.9) / kNanosecondsPerMicrosecond, 'f', 1) + " / "
+            + QString::number(histogram.max() / kNanosecondsPerMicrosecond, 'f', 1) + " us";
+}
@@ -4,13 +4,24 @@
 #include <QWidget>
 #include <QMessageBox>
 #include <phidget21.h>
+#include "absolute_pointer.h"
+#include "ballistics_curve.h"
+#include "cursor_model.h"
+#include "cursor_output.h"
+#include "dwell_detector.h"
+#include "filter_bank.h"
+#include "latency_histogram.h"
+#include "output_coalescer.h"
 #include "overlay.h"
+#include "pointer_motion.h"
 
 namespace Ui {
     class SpatialPointer;
 }
 
 class PhidgetSpatial;
+class PointerPipeline;
+class QScreen;
 
 class SpatialPointer : public QWidget
 {
@@ -18,16 +29,25 @@ class SpatialPointer : public QWidget
 
 public:
 
-    explicit SpatialPointer(QWidget *parent = 0);
+    explicit SpatialPointer(CursorOutput* output, QWidget *parent = 0);
     ~SpatialPointer();
 
+    void set_output_settings(const OutputSettings& settings, const bool& follow_refresh);
+
 private slots:
 
-    void slot_update();
-    void slot_activate_click();
+    void slot_cursor_moved(const QPoint& position);
+    void slot_dwell_armed(const QPoint& position);
+    void slot_dwell_cancelled();
+    void slot_detached();
+    void slot_update_diagnostics();
+    void slot_desktop_changed();
+    void slot_screen_added(QScreen* screen);
 
     void on_sld_deadzone_valueChanged(int value);
     void on_sld_speed_valueChanged(int value);
+    void on_sld_min_cutoff_valueChanged(int value);
+    void on_sld_beta_valueChanged(int value);
 
     void on_btn_enable_clicked();
     void on_btn_disable_clicked();
@@ -46,49 +66,112 @@ private slots:
 
     void on_chk_clicking_enabled_toggled(bool checked);
 
+    void on_chk_absolute_toggled(bool checked);
+
+    void on_cmb_filter_currentIndexChanged(int index);
+
+    void on_spn_filter_frequency_valueChanged(int value);
+
+    void on_btn_filter_taps_clicked();
+
+    void on_chk_tremor_toggled(bool checked);
+
+    void on_spn_look_ahead_valueChanged(int value);
+
+    void on_cmb_profile_currentIndexChanged(int index);
+
+    void on_btn_acceleration_curve_clicked();
+
+    void on_btn_save_latency_clicked();
+
+    void on_btn_reset_latency_clicked();
+
 private:
 
 
 
     Ui::SpatialPointer *ui;
 
-    QTimer* tmr_update;
-    QTimer* tmr_activate_click;
+    QTimer* tmr_diagnostics;
 
     PhidgetSpatial* spatial_;
 
     Overlay* overlay_;
 
-    const int kUpdateRate = 10;
+    PointerPipeline* pipeline_;
+
+    const int kDiagnosticsUpdateRate = 250;
 
     const int kStartClickRadius = 100;
     const float kActivateClickTime = 1000.0f;
 
+    // Head rotation (degrees) spanning the desktop in absolute mode at the lowest speed, higher
+    // speeds divide it
+    const double kAbsoluteRange = 120.0;
+
+    // Smoothing per step of the minimum cut-off (hertz) and beta (hertz per pixel per second) sliders
+    const double kMinCutoffStep = 0.5;
+    const double kBetaStep = 0.001;
+
     const QString kStatusIdle = "Click the green arrow to begin pointing";
     const QString kStatusFail = "Please ensure your spatial sensor is attatched";
     const QString kStatusWorking = "Active";
 
     int tolerance_;
     int speed_;
+    int min_cutoff_;
+    int beta_;
     int radius_;
     int trigger_time_;
     int click_time_;
 
+    // Time (milliseconds) the head's rotation is extrapolated ahead
+    int look_ahead_;
+
     bool horizontal_;
     bool vertical_;
     bool invert_;
     bool enabled_;
     bool clicking_enabled_;
+    bool absolute_;
+
+    // Arrangement of the monitors, refreshed whenever a screen is added, removed or changes geometry
+    DesktopLayout desktop_;
+
+    // Cadence of the cursor moves, the rate follows the fastest monitor's refresh rate when asked to
+    const double kDefaultRefreshRate = 60.0;
+    OutputSettings output_;
+    bool follow_refresh_;
+
+    // Filter bank selection, the spin box holds the frequency or moving average length of the selected filter
+    FilterSettings filter_;
+
+    // Acceleration curve of the selected profile, profiles are kept with QSettings
+    const QString kDefaultProfile = "Default";
+    QString profile_;
+    BallisticsSettings ballistics_;
 
     void set_enabled(const bool& state);
 
-    void move_cursor(const int& x, const int& y);
+    PointerSettings pointer_settings() const;
+    DwellSettings dwell_settings() const;
+    AbsoluteSettings absolute_settings() const;
+    DesktopLayout desktop_layout() const;
+    double refresh_rate() const;
 
-    int abs_difference(const int& x, const int& y);
+    void update_filter_controls();
+    void update_smoothing_label();
+    void update_acceleration_label();
 
-    void show_message_box(const QString& message, const QString& caption, const QMessageBox::Icon& icon);
+    void load_profiles();
+    bool load_profile(const QString& name);
+    void save_profile() const;
+
+    void move_overlay(const QPoint& position);
 
-    QPoint old_mouse_position;
+    static QString format_latency(const LatencyHistogram& histogram);
+
+    void show_message_box(const QString& message, const QString& caption, const QMessageBox::Icon& icon);
 
 };
 
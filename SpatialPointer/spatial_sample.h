@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+#include "linear_algebra.h"
+
+/**
+ * \brief A single timestamped packet reported by the PhidgetSpatial
+ */
+struct SpatialSample
+{
+
+    Vec3d acceleration;
+    Vec3d angular_rate;
+    Vec3d magnetic_field;
+
+    // Hardware timestamp (seconds since the Phidget began reporting)
+    double timestamp = 0.0;
+
+    // Monotonic time at which the packet was received from the Phidget (nanoseconds)
+    std::int64_t ingest_time = 0;
+
+};
@@ -0,0 +1,35 @@
+#pragma once
+
+class PhidgetSpatial;
+
+/**
+ * \brief Alternative producer of PhidgetSpatial packets, used in place of the phidget21 hardware
+ *
+ * A source delivers its packets through PhidgetSpatial::inject_packets, which runs the same
+ * DataHandler path as packets from a physical Phidget Spatial 3/3/3.
+ */
+class SpatialSource
+{
+
+ public:
+
+    virtual ~SpatialSource() {}
+
+    /**
+     * \brief Begins delivering packets to the given PhidgetSpatial, returns false on failure
+     * \param spatial receiver of the packets
+     */
+    virtual bool open(PhidgetSpatial* spatial) = 0;
+
+    /**
+     * \brief Stops delivering packets, no packets are delivered once this returns
+     */
+    virtual void close() = 0;
+
+    /**
+     * \brief Returns the rate of the packets by their timestamps (packets per second), only
+     * meaningful once the source has been opened
+     */
+    virtual double sample_rate() const = 0;
+
+};
@@ -0,0 +1,97 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * \brief Fixed capacity, lock-free ring buffer for exactly one producer thread and one consumer thread
+ *
+ * When the buffer is full the newest item is dropped and counted as an overflow, the producer
+ * never blocks and never touches the consumer's index.
+ */
+template<class T, std::size_t Capacity>
+class SpscRingBuffer
+{
+    static_assert(Capacity > 0 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+ public:
+
+    SpscRingBuffer() : head_(0), tail_(0), overflows_(0) {}
+
+    /**
+     * \brief Appends an item (producer thread only), returns false if the buffer was full
+     * \param item item to append
+     */
+    bool push(const T& item)
+    {
+        const std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_.load(std::memory_order_acquire) == Capacity)
+        {
+            overflows_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        buffer_[head & kMask] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \brief Removes the oldest item (consumer thread only), returns false if the buffer was empty
+     * \param item receives the removed item
+     */
+    bool pop(T& item)
+    {
+        const std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_.load(std::memory_order_acquire))
+        {
+            return false;
+        }
+        item = buffer_[tail & kMask];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * \brief Discards every queued item and resets the overflow counter (consumer thread only)
+     */
+    void clear()
+    {
+        tail_.store(head_.load(std::memory_order_acquire), std::memory_order_release);
+        overflows_.store(0, std::memory_order_relaxed);
+    }
+
+    /**
+     * \brief Returns the number of queued items
+     */
+    std::size_t size() const
+    {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    /**
+     * \brief Returns the number of items dropped because the buffer was full
+     */
+    std::uint64_t overflow_count() const
+    {
+        return overflows_.load(std::memory_order_relaxed);
+    }
+
+    static constexpr std::size_t capacity() { return Capacity; }
+
+ private:
+
+    static constexpr std::size_t kMask = Capacity - 1;
+
+    static constexpr std::size_t kCacheLine = 64;
+
+    // Producer and consumer indices are padded onto separate cache lines to avoid false sharing
+    std::atomic<std::size_t> head_;
+    char head_padding_[kCacheLine - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::size_t> tail_;
+    char tail_padding_[kCacheLine - sizeof(std::atomic<std::size_t>)];
+    std::atomic<std::uint64_t> overflows_;
+    char overflows_padding_[kCacheLine - sizeof(std::atomic<std::uint64_t>)];
+
+    T buffer_[Capacity];
+
+};
@@ -0,0 +1,198 @@
+#include "tremor_estimator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+const double kPi = 3.14159265358979323846;
+
+const SampleBlock::Channel kRateChannels[] = { SampleBlock::kAngularRateX, SampleBlock::kAngularRateY, SampleBlock::kAngularRateZ };
+
+}
+
+TremorEstimator::TremorEstimator() : sample_rate_(0.0)
+{
+    set_sample_rate(125.0);
+}
+
+/**
+ * \brief Sets the rate packets arrive at, the estimate restarts when it changes
+ * \param sample_rate packets per second
+ */
+void TremorEstimator::set_sample_rate(const double& sample_rate)
+{
+    if (sample_rate == sample_rate_)
+    {
+        return;
+    }
+    sample_rate_ = sample_rate;
+
+    // A one second window puts bin k at k hertz, bins at or above the Nyquist frequency are dropped
+    window_ = std::min(std::max(static_cast<int>(std::lround(sample_rate_)), 1), static_cast<int>(kMaxWindow));
+    const double resolution = sample_rate_ / window_;
+    first_bin_ = static_cast<int>(std::ceil(kMinFrequency / resolution)) - 1;
+    const int last_bin = std::min(static_cast<int>(std::floor(kMaxFrequency / resolution)) + 1, (window_ - 1) / 2);
+    bin_count_ = std::min(std::max(last_bin - first_bin_ + 1, 0), static_cast<int>(kMaxBins));
+
+    for (int b = 0; b < bin_count_; ++b)
+    {
+        const double omega = 2.0 * kPi * (first_bin_ + b) / window_;
+        rotation_real_[b] = kDamping * std::cos(omega);
+        rotation_imaginary_[b] = kDamping * std::sin(omega);
+    }
+    damping_window_ = std::pow(kDamping, window_);
+
+    reset();
+}
+
+/**
+ * \brief Forgets the window and any detected tremor
+ */
+void TremorEstimator::reset()
+{
+    std::fill(&spectrum_real_[0][0], &spectrum_real_[0][0] + kAxes * kMaxBins, 0.0);
+    std::fill(&spectrum_imaginary_[0][0], &spectrum_imaginary_[0][0] + kAxes * kMaxBins, 0.0);
+    std::fill(&history_[0][0], &history_[0][0] + kAxes * kMaxWindow, 0.0f);
+    position_ = 0;
+    filled_ = 0;
+    detected_ = false;
+    frequency_ = 0.0;
+    amplitude_ = 0.0;
+}
+
+/**
+ * \brief Adds a run of continuous packets to the window and re-evaluates the tremor
+ * \param block packets reported by the PhidgetSpatial, after bias correction
+ * \param begin index of the first packet of the run
+ * \param end index one past the last packet of the run
+ */
+void TremorEstimator::update(const SampleBlock& block, const std::size_t& begin, const std::size_t& end)
+{
+    if (bin_count_ < 3 || end <= begin)
+    {
+        return;
+    }
+
+    for (std::size_t i = begin; i < end; ++i)
+    {
+        for (int a = 0; a < kAxes; ++a)
+        {
+            const float input = block.channel(kRateChannels[a])[i];
+            const double change = input - damping_window_ * history_[a][position_];
+            history_[a][position_] = input;
+
+            double* real = spectrum_real_[a];
+            double* imaginary = spectrum_imaginary_[a];
+            for (int b = 0; b < bin_count_; ++b)
+            {
+                const double r = real[b] + change;
+                const double m = imaginary[b];
+                real[b] = r * rotation_real_[b] - m * rotation_imaginary_[b];
+                imaginary[b] = r * rotation_imaginary_[b] + m * rotation_real_[b];
+            }
+        }
+
+        position_ = position_ + 1 == window_ ? 0 : position_ + 1;
+        filled_ = std::min(filled_ + 1, window_);
+    }
+
+    detect();
+}
+
+/**
+ * \brief Returns whether a tremor is currently detected
+ */
+bool TremorEstimator::detected() const
+{
+    return detected_;
+}
+
+/**
+ * \brief Returns the frequency (hertz) of the detected tremor
+ */
+double TremorEstimator::frequency() const
+{
+    return frequency_;
+}
+
+/**
+ * \brief Returns the amplitude (degrees per second) of the strongest frequency in the tremor band
+ */
+double TremorEstimator::amplitude() const
+{
+    return amplitude_;
+}
+
+/**
+ * \brief Finds the strongest bin of the band and decides whether it is a tremor
+ */
+void TremorEstimator::detect()
+{
+    // The spectrum is meaningless until the window has filled
+    if (filled_ < window_)
+    {
+        return;
+    }
+
+    // Amplitude of each bin between the guard bins once Hann windowed
+    double amplitudes[kMaxBins] = {};
+    const int bands = bin_count_ - 2;
+    int peak = 0;
+    double total = 0.0;
+    for (int b = 0; b < bands; ++b)
+    {
+        double power = 0.0;
+        for (int a = 0; a < kAxes; ++a)
+        {
+            const double* real = spectrum_real_[a] + b;
+            const double* imaginary = spectrum_imaginary_[a] + b;
+            const double windowed_real = 0.5 * real[1] - 0.25 * (real[0] + real[2]);
+            const double windowed_imaginary = 0.5 * imaginary[1] - 0.25 * (imaginary[0] + imaginary[2]);
+            power += windowed_real * windowed_real + windowed_imaginary * windowed_imaginary;
+        }
+
+        // A sinusoid of amplitude A gives a windowed bin of magnitude A * window / 4
+        amplitudes[b] = 4.0 * std::sqrt(power) / window_;
+        total += amplitudes[b];
+        if (amplitudes[b] > amplitudes[peak])
+        {
+            peak = b;
+        }
+    }
+
+    amplitude_ = amplitudes[peak];
+    const double rest = bands > 1 ? (total - amplitude_) / (bands - 1) : 0.0;
+    const bool prominent = amplitude_ >= kPeakRatio * rest;
+
+    if (detected_)
+    {
+        detected_ = prominent && amplitude_ >= kReleaseAmplitude;
+    }
+    else
+    {
+        detected_ = prominent && amplitude_ >= kDetectAmplitude;
+        frequency_ = 0.0;
+    }
+
+    if (!detected_)
+    {
+        return;
+    }
+
+    // Fit a parabola through the peak and its neighbours to place it between bins
+    double offset = 0.0;
+    if (peak > 0 && peak + 1 < bands)
+    {
+        const double left = amplitudes[peak - 1];
+        const double right = amplitudes[peak + 1];
+        const double curvature = left - 2.0 * amplitude_ + right;
+        if (curvature < 0.0)
+        {
+            offset = 0.5 * (left - right) / curvature;
+        }
+    }
+
+    const double measured = (first_bin_ + 1 + peak + offset) * sample_rate_ / window_;
+    frequency_ = frequency_ > 0.0 ? frequency_ + (measured - frequency_) * kFrequencySmoothing : measured;
+}
@@ -0,0 +1,83 @@
+#pragma once
+#include <cstddef>
+#include "sample_block.h"
+
+/**
+ * \brief Detects a dominant head tremor in the angular rate
+ *
+ * A sliding DFT over the last second of each gyroscope axis tracks one bin per hertz across the
+ * tremor band, so each packet costs a complex multiply per bin and axis and nothing is allocated.
+ * After each run of packets the spectrum is Hann windowed (by combining neighbouring bins, so the
+ * band carries one extra bin at each end) and the bin with the most energy summed over the axes is
+ * taken as a tremor when it is both strong and well above the rest of the band. Its frequency is
+ * refined by interpolating between the neighbouring bins.
+ */
+class TremorEstimator
+{
+
+ public:
+
+    TremorEstimator();
+
+    void set_sample_rate(const double& sample_rate);
+
+    void reset();
+
+    void update(const SampleBlock& block, const std::size_t& begin, const std::size_t& end);
+
+    bool detected() const;
+    double frequency() const;
+    double amplitude() const;
+
+ private:
+
+    static const int kAxes = 3;
+    static const int kMaxWindow = 512;
+    static const int kMaxBins = 18;
+
+    // Tremor band (hertz)
+    const double kMinFrequency = 3.0;
+    const double kMaxFrequency = 12.0;
+
+    // Pole radius of the sliding DFT, slightly inside the unit circle so rounding errors decay
+    const double kDamping = 0.99999;
+
+    // Amplitude (degrees per second) above which a peak is a tremor, and below which a detected
+    // tremor is released
+    const double kDetectAmplitude = 1.5;
+    const double kReleaseAmplitude = 0.75;
+
+    // Smallest ratio of the peak's amplitude to the average of the rest of the band
+    const double kPeakRatio = 3.0;
+
+    // Proportion of the difference between the estimate and a new measurement applied per update
+    const double kFrequencySmoothing = 0.2;
+
+    double sample_rate_;
+
+    // Window length (packets) and the bins of the tremor band including a guard bin at each end,
+    // bin k is k hertz
+    int window_;
+    int first_bin_;
+    int bin_count_;
+
+    // Per bin rotation applied every packet, and the damping of a packet leaving the window
+    double rotation_real_[kMaxBins];
+    double rotation_imaginary_[kMaxBins];
+    double damping_window_;
+
+    double spectrum_real_[kAxes][kMaxBins];
+    double spectrum_imaginary_[kAxes][kMaxBins];
+
+    // The last window_ packets of each axis
+    float history_[kAxes][kMaxWindow];
+    int position_;
+    int filled_;
+
+    bool detected_;
+    double frequency_;
+    double amplitude_;
+
+    void detect();
+
+};
@@ -0,0 +1,170 @@
+#include "uinput_cursor_output.h"
+#include "monotonic_clock.h"
+#ifdef __linux__
+#include <cstring>
+#include <fcntl.h>
+#include <linux/uinput.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+const char* const UinputCursorOutput::kDeviceName = "Pointy virtual mouse";
+
+#ifdef __linux__
+
+namespace
+{
+
+/**
+ * \brief Fills in an input event
+ */
+void set_event(input_event& event, const int& type, const int& code, const int& value)
+{
+    std::memset(&event, 0, sizeof(event));
+    event.type = static_cast<unsigned short>(type);
+    event.code = static_cast<unsigned short>(code);
+    event.value = value;
+}
+
+}
+
+#endif
+
+UinputCursorOutput::UinputCursorOutput() : device_(-1), landed_time_(0)
+{
+}
+
+UinputCursorOutput::~UinputCursorOutput()
+{
+    close();
+}
+
+/**
+ * \brief Creates the virtual mouse
+ * \return false when uinput is unavailable or not writable
+ */
+bool UinputCursorOutput::open()
+{
+#ifdef __linux__
+    if (device_ >= 0)
+    {
+        return true;
+    }
+
+    device_ = ::open("/dev/uinput", O_WRONLY | O_NONBLOCK | O_CLOEXEC);
+    if (device_ < 0)
+    {
+        return false;
+    }
+
+    // Display servers only treat a device as a mouse if it has relative axes and buttons
+    bool configured = ioctl(device_, UI_SET_EVBIT, EV_KEY) == 0 && ioctl(device_, UI_SET_KEYBIT, BTN_LEFT) == 0
+            && ioctl(device_, UI_SET_KEYBIT, BTN_RIGHT) == 0 && ioctl(device_, UI_SET_EVBIT, EV_REL) == 0
+            && ioctl(device_, UI_SET_RELBIT, REL_X) == 0 && ioctl(device_, UI_SET_RELBIT, REL_Y) == 0;
+
+    uinput_user_dev device;
+    std::memset(&device, 0, sizeof(device));
+    std::strncpy(device.name, kDeviceName, UINPUT_MAX_NAME_SIZE - 1);
+    device.id.bustype = BUS_VIRTUAL;
+    device.id.version = 1;
+
+    // The legacy setup write is understood by every kernel that has uinput
+    configured = configured && write(device_, &device, sizeof(device)) == static_cast<ssize_t>(sizeof(device))
+            && ioctl(device_, UI_DEV_CREATE) == 0;
+    if (!configured)
+    {
+        ::close(device_);
+        device_ = -1;
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif
+}
+
+/**
+ * \brief Destroys the virtual mouse
+ */
+void UinputCursorOutput::close()
+{
+#ifdef __linux__
+    if (device_ < 0)
+    {
+        return;
+    }
+
+    ioctl(device_, UI_DEV_DESTROY);
+    ::close(device_);
+    device_ = -1;
+#endif
+}
+
+/**
+ * \brief The virtual mouse only reports movement
+ */
+bool UinputCursorOutput::relative() const
+{
+    return true;
+}
+
+/**
+ * \brief Reports a movement of the virtual mouse
+ * \param dx horizontal displacement (pixels)
+ * \param dy vertical displacement (pixels)
+ * \param x horizontal position (pixels across the virtual desktop), unused
+ * \param y vertical position (pixels across the virtual desktop), unused
+ */
+void UinputCursorOutput::move(const int& dx, const int& dy, const int& x, const int& y)
+{
+    (void)x;
+    (void)y;
+#ifdef __linux__
+    if (device_ < 0)
+    {
+        return;
+    }
+
+    input_event events[3];
+    set_event(events[0], EV_REL, REL_X, dx);
+    set_event(events[1], EV_REL, REL_Y, dy);
+    set_event(events[2], EV_SYN, SYN_REPORT, 0);
+    const ssize_t written = write(device_, events, sizeof(events));
+    (void)written;
+#else
+    (void)dx;
+    (void)dy;
+#endif
+    landed_time_ = monotonic_ns();
+}
+
+/**
+ * \brief Moves are written to the kernel before move returns, so they have always landed
+ * \param time receives when the last move was written
+ */
+bool UinputCursorOutput::landed(std::int64_t& time) const
+{
+    time = landed_time_;
+    return true;
+}
+
+/**
+ * \brief Presses and releases the virtual mouse's left button
+ */
+void UinputCursorOutput::click()
+{
+#ifdef __linux__
+    if (device_ < 0)
+    {
+        return;
+    }
+
+    input_event events[4];
+    set_event(events[0], EV_KEY, BTN_LEFT, 1);
+    set_event(events[1], EV_SYN, SYN_REPORT, 0);
+    set_event(events[2], EV_KEY, BTN_LEFT, 0);
+    set_event(events[3], EV_SYN, SYN_REPORT, 0);
+    const ssize_t written = write(device_, events, sizeof(events));
+    (void)written;
+#endif
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include "cursor_output.h"
+
+/**
+ * \brief Virtual mouse created through Linux's uinput, moves the cursor with REL_X / REL_Y and
+ * clicks with BTN_LEFT
+ *
+ * Events are written straight to the kernel from the calling thread, so moving the cursor never
+ * waits on the display server and works the same under X11, Wayland and on the console. Each move
+ * or click is a single write ending in SYN_REPORT, which uinput applies atomically, so the
+ * pipeline and the overlay may use the device at the same time.
+ *
+ * Creating the device requires write access to /dev/uinput (e.g. a udev rule granting it to the
+ * user's group). The display server treats the device like any other mouse and applies its own
+ * pointer acceleration, which should be set to flat so Pointy's speed and acceleration curve are
+ * used unchanged. On other platforms the output is never available.
+ */
+class UinputCursorOutput : public CursorOutput
+{
+
+ public:
+
+    UinputCursorOutput();
+    ~UinputCursorOutput();
+
+    bool open() override;
+    void close() override;
+
+    bool relative() const override;
+
+    void move(const int& dx, const int& dy, const int& x, const int& y) override;
+    bool landed(std::int64_t& time) const override;
+    void click() override;
+
+ private:
+
+    // Name of the virtual mouse as listed by the display server
+    static const char* const kDeviceName;
+
+    int device_;
+
+    // When the last move was written (nanoseconds of the monotonic clock)
+    std::int64_t landed_time_;
+
+};
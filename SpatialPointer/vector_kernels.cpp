@@ -0,0 +1,386 @@
+#include "vector_kernels.h"
+#include "simd.h"
+#include <cmath>
+
+namespace
+{
+
+#ifdef POINTY_SSE2
+
+/**
+ * \brief Loads four consecutive Vec3f (twelve floats) and transposes them into one register per axis
+ */
+inline void load_vectors(const float* data, __m128& x, __m128& y, __m128& z)
+{
+    // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+    const __m128 a = _mm_loadu_ps(data);
+    const __m128 b = _mm_loadu_ps(data + 4);
+    const __m128 c = _mm_loadu_ps(data + 8);
+
+    x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), _mm_shuffle_ps(c, c, _MM_SHUFFLE(3, 3, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+}
+
+/**
+ * \brief Inverse of load_vectors
+ */
+inline void store_vectors(float* data, const __m128& x, const __m128& y, const __m128& z)
+{
+    const __m128 a = _mm_shuffle_ps(_mm_shuffle_ps(x, y, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 b = _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(x, y, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 c = _mm_shuffle_ps(_mm_shuffle_ps(z, x, _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(y, z, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+
+    _mm_storeu_ps(data, a);
+    _mm_storeu_ps(data + 4, b);
+    _mm_storeu_ps(data + 8, c);
+}
+
+#endif
+
+#ifdef POINTY_AVX
+
+/**
+ * \brief Loads four consecutive Vec3d (twelve doubles) and transposes them into one register per axis
+ */
+inline void load_vectors(const double* data, __m256d& x, __m256d& y, __m256d& z)
+{
+    // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+    const __m256d a = _mm256_loadu_pd(data);
+    const __m256d b = _mm256_loadu_pd(data + 4);
+    const __m256d c = _mm256_loadu_pd(data + 8);
+
+    // Pair up the halves holding the same components: x0 y0 x2 y2, z0 x1 z2 x3, y1 z1 y3 z3
+    const __m256d p = _mm256_permute2f128_pd(a, b, 0x30);
+    const __m256d q = _mm256_permute2f128_pd(a, c, 0x21);
+    const __m256d r = _mm256_permute2f128_pd(b, c, 0x30);
+
+    x = _mm256_shuffle_pd(p, q, 0xA);
+    y = _mm256_shuffle_pd(p, r, 0x5);
+    z = _mm256_shuffle_pd(q, r, 0xA);
+}
+
+/**
+ * \brief Inverse of load_vectors
+ */
+inline void store_vectors(double* data, const __m256d& x, const __m256d& y, const __m256d& z)
+{
+    const __m256d p = _mm256_shuffle_pd(x, y, 0x0);
+    const __m256d q = _mm256_shuffle_pd(z, x, 0xA);
+    const __m256d r = _mm256_shuffle_pd(y, z, 0xF);
+
+    _mm256_storeu_pd(data, _mm256_permute2f128_pd(p, q, 0x20));
+    _mm256_storeu_pd(data + 4, _mm256_permute2f128_pd(r, p, 0x30));
+    _mm256_storeu_pd(data + 8, _mm256_permute2f128_pd(q, r, 0x31));
+}
+
+#elif defined(POINTY_SSE2)
+
+/**
+ * \brief Loads two consecutive Vec3d (six doubles) and transposes them into one register per axis
+ */
+inline void load_vectors(const double* data, __m128d& x, __m128d& y, __m128d& z)
+{
+    // a = x0 y0, b = z0 x1, c = y1 z1
+    const __m128d a = _mm_loadu_pd(data);
+    const __m128d b = _mm_loadu_pd(data + 2);
+    const __m128d c = _mm_loadu_pd(data + 4);
+
+    x = _mm_shuffle_pd(a, b, 2);
+    y = _mm_shuffle_pd(a, c, 1);
+    z = _mm_shuffle_pd(b, c, 2);
+}
+
+/**
+ * \brief Inverse of load_vectors
+ */
+inline void store_vectors(double* data, const __m128d& x, const __m128d& y, const __m128d& z)
+{
+    _mm_storeu_pd(data, _mm_shuffle_pd(x, y, 0));
+    _mm_storeu_pd(data + 2, _mm_shuffle_pd(z, x, 2));
+    _mm_storeu_pd(data + 4, _mm_shuffle_pd(y, z, 3));
+}
+
+#endif
+
+}
+
+/**
+ * \brief Adds an offset to every vector
+ * \param vectors array of vectors, modified in place
+ * \param count number of vectors
+ * \param offset offset to add
+ */
+void batch_add(Vec3f* vectors, const std::size_t& count, const Vec3f& offset)
+{
+    float* data = &vectors[0].x;
+    const std::size_t size = count * 3;
+    std::size_t i = 0;
+
+#if defined(POINTY_AVX)
+    // Eight vectors span three registers, each register starting on a different component
+    const __m256 o0 = _mm256_setr_ps(offset.x, offset.y, offset.z, offset.x, offset.y, offset.z, offset.x, offset.y);
+    const __m256 o1 = _mm256_setr_ps(offset.z, offset.x, offset.y, offset.z, offset.x, offset.y, offset.z, offset.x);
+    const __m256 o2 = _mm256_setr_ps(offset.y, offset.z, offset.x, offset.y, offset.z, offset.x, offset.y, offset.z);
+    for (; i + 24 <= size; i += 24)
+    {
+        _mm256_storeu_ps(data + i, _mm256_add_ps(_mm256_loadu_ps(data + i), o0));
+        _mm256_storeu_ps(data + i + 8, _mm256_add_ps(_mm256_loadu_ps(data + i + 8), o1));
+        _mm256_storeu_ps(data + i + 16, _mm256_add_ps(_mm256_loadu_ps(data + i + 16), o2));
+    }
+#elif defined(POINTY_SSE2)
+    const __m128 o0 = _mm_setr_ps(offset.x, offset.y, offset.z, offset.x);
+    const __m128 o1 = _mm_setr_ps(offset.y, offset.z, offset.x, offset.y);
+    const __m128 o2 = _mm_setr_ps(offset.z, offset.x, offset.y, offset.z);
+    for (; i + 12 <= size; i += 12)
+    {
+        _mm_storeu_ps(data + i, _mm_add_ps(_mm_loadu_ps(data + i), o0));
+        _mm_storeu_ps(data + i + 4, _mm_add_ps(_mm_loadu_ps(data + i + 4), o1));
+        _mm_storeu_ps(data + i + 8, _mm_add_ps(_mm_loadu_ps(data + i + 8), o2));
+    }
+#endif
+
+    for (; i < size; i += 3)
+    {
+        data[i] += offset.x;
+        data[i + 1] += offset.y;
+        data[i + 2] += offset.z;
+    }
+}
+
+/**
+ * \brief Adds an offset to every vector
+ * \param vectors array of vectors, modified in place
+ * \param count number of vectors
+ * \param offset offset to add
+ */
+void batch_add(Vec3d* vectors, const std::size_t& count, const Vec3d& offset)
+{
+    double* data = &vectors[0].x;
+    const std::size_t size = count * 3;
+    std::size_t i = 0;
+
+#if defined(POINTY_AVX)
+    const __m256d o0 = _mm256_setr_pd(offset.x, offset.y, offset.z, offset.x);
+    const __m256d o1 = _mm256_setr_pd(offset.y, offset.z, offset.x, offset.y);
+    const __m256d o2 = _mm256_setr_pd(offset.z, offset.x, offset.y, offset.z);
+    for (; i + 12 <= size; i += 12)
+    {
+        _mm256_storeu_pd(data + i, _mm256_add_pd(_mm256_loadu_pd(data + i), o0));
+        _mm256_storeu_pd(data + i + 4, _mm256_add_pd(_mm256_loadu_pd(data + i + 4), o1));
+        _mm256_storeu_pd(data + i + 8, _mm256_add_pd(_mm256_loadu_pd(data + i + 8), o2));
+    }
+#elif defined(POINTY_SSE2)
+    const __m128d o0 = _mm_setr_pd(offset.x, offset.y);
+    const __m128d o1 = _mm_setr_pd(offset.z, offset.x);
+    const __m128d o2 = _mm_setr_pd(offset.y, offset.z);
+    for (; i + 6 <= size; i += 6)
+    {
+        _mm_storeu_pd(data + i, _mm_add_pd(_mm_loadu_pd(data + i), o0));
+        _mm_storeu_pd(data + i + 2, _mm_add_pd(_mm_loadu_pd(data + i + 2), o1));
+        _mm_storeu_pd(data + i + 4, _mm_add_pd(_mm_loadu_pd(data + i + 4), o2));
+    }
+#endif
+
+    for (; i < size; i += 3)
+    {
+        data[i] += offset.x;
+        data[i + 1] += offset.y;
+        data[i + 2] += offset.z;
+    }
+}
+
+/**
+ * \brief Multiplies every vector by a scalar
+ * \param vectors array of vectors, modified in place
+ * \param count number of vectors
+ * \param scalar factor
+ */
+void batch_scale(Vec3f* vectors, const std::size_t& count, const float& scalar)
+{
+    float* data = &vectors[0].x;
+    const std::size_t size = count * 3;
+    std::size_t i = 0;
+
+#if defined(POINTY_AVX)
+    const __m256 factor = _mm256_set1_ps(scalar);
+    for (; i + 8 <= size; i += 8)
+        _mm256_storeu_ps(data + i, _mm256_mul_ps(_mm256_loadu_ps(data + i), factor));
+#elif defined(POINTY_SSE2)
+    const __m128 factor = _mm_set1_ps(scalar);
+    for (; i + 4 <= size; i += 4)
+        _mm_storeu_ps(data + i, _mm_mul_ps(_mm_loadu_ps(data + i), factor));
+#endif
+
+    for (; i < size; ++i)
+        data[i] *= scalar;
+}
+
+/**
+ * \brief Multiplies every vector by a scalar
+ * \param vectors array of vectors, modified in place
+ * \param count number of vectors
+ * \param scalar factor
+ */
+void batch_scale(Vec3d* vectors, const std::size_t& count, const double& scalar)
+{
+    double* data = &vectors[0].x;
+    const std::size_t size = count * 3;
+    std::size_t i = 0;
+
+#if defined(POINTY_AVX)
+    const __m256d factor = _mm256_set1_pd(scalar);
+    for (; i + 4 <= size; i += 4)
+        _mm256_storeu_pd(data + i, _mm256_mul_pd(_mm256_loadu_pd(data + i), factor));
+#elif defined(POINTY_SSE2)
+    const __m128d factor = _mm_set1_pd(scalar);
+    for (; i + 2 <= size; i += 2)
+        _mm_storeu_pd(data + i, _mm_mul_pd(_mm_loadu_pd(data + i), factor));
+#endif
+
+    for (; i < size; ++i)
+        data[i] *= scalar;
+}
+
+/**
+ * \brief Writes the length of every vector
+ * \param vectors array of vectors
+ * \param count number of vectors
+ * \param lengths receives count lengths
+ */
+void batch_length(const Vec3f* vectors, const std::size_t& count, float* lengths)
+{
+    std::size_t i = 0;
+
+#if defined(POINTY_SSE2)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x, y, z;
+        load_vectors(&vectors[i].x, x, y, z);
+        const __m128 squared = _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z));
+        _mm_storeu_ps(lengths + i, _mm_sqrt_ps(squared));
+    }
+#endif
+
+    for (; i < count; ++i)
+        lengths[i] = length(vectors[i]);
+}
+
+/**
+ * \brief Writes the length of every vector
+ * \param vectors array of vectors
+ * \param count number of vectors
+ * \param lengths receives count lengths
+ */
+void batch_length(const Vec3d* vectors, const std::size_t& count, double* lengths)
+{
+    std::size_t i = 0;
+
+#if defined(POINTY_AVX)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d x, y, z;
+        load_vectors(&vectors[i].x, x, y, z);
+        const __m256d squared = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(y, y)), _mm256_mul_pd(z, z));
+        _mm256_storeu_pd(lengths + i, _mm256_sqrt_pd(squared));
+    }
+#elif defined(POINTY_SSE2)
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d x, y, z;
+        load_vectors(&vectors[i].x, x, y, z);
+        const __m128d squared = _mm_add_pd(_mm_add_pd(_mm_mul_pd(x, x), _mm_mul_pd(y, y)), _mm_mul_pd(z, z));
+        _mm_storeu_pd(lengths + i, _mm_sqrt_pd(squared));
+    }
+#endif
+
+    for (; i < count; ++i)
+        lengths[i] = length(vectors[i]);
+}
+
+/**
+ * \brief Multiplies every vector by a matrix
+ * \param matrix matrix to apply
+ * \param in array of vectors
+ * \param out receives count vectors, may be the same array as in
+ * \param count number of vectors
+ */
+void batch_transform(const Mat3f& matrix, const Vec3f* in, Vec3f* out, const std::size_t& count)
+{
+    std::size_t i = 0;
+
+#if defined(POINTY_SSE2)
+    const __m128 m00 = _mm_set1_ps(matrix.r0.x), m01 = _mm_set1_ps(matrix.r0.y), m02 = _mm_set1_ps(matrix.r0.z);
+    const __m128 m10 = _mm_set1_ps(matrix.r1.x), m11 = _mm_set1_ps(matrix.r1.y), m12 = _mm_set1_ps(matrix.r1.z);
+    const __m128 m20 = _mm_set1_ps(matrix.r2.x), m21 = _mm_set1_ps(matrix.r2.y), m22 = _mm_set1_ps(matrix.r2.z);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x, y, z;
+        load_vectors(&in[i].x, x, y, z);
+        const __m128 tx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, x), _mm_mul_ps(m01, y)), _mm_mul_ps(m02, z));
+        const __m128 ty = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m10, x), _mm_mul_ps(m11, y)), _mm_mul_ps(m12, z));
+        const __m128 tz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m20, x), _mm_mul_ps(m21, y)), _mm_mul_ps(m22, z));
+        store_vectors(&out[i].x, tx, ty, tz);
+    }
+#endif
+
+    for (; i < count; ++i)
+        out[i] = matrix * in[i];
+}
+
+/**
+ * \brief Multiplies every vector by a matrix
+ * \param matrix matrix to apply
+ * \param in array of vectors
+ * \param out receives count vectors, may be the same array as in
+ * \param count number of vectors
+ */
+void batch_transform(const Mat3d& matrix, const Vec3d* in, Vec3d* out, const std::size_t& count)
+{
+    std::size_t i = 0;
+
+#if defined(POINTY_AVX)
+    const __m256d m00 = _mm256_set1_pd(matrix.r0.x), m01 = _mm256_set1_pd(matrix.r0.y), m02 = _mm256_set1_pd(matrix.r0.z);
+    const __m256d m10 = _mm256_set1_pd(matrix.r1.x), m11 = _mm256_set1_pd(matrix.r1.y), m12 = _mm256_set1_pd(matrix.r1.z);
+    const __m256d m20 = _mm256_set1_pd(matrix.r2.x), m21 = _mm256_set1_pd(matrix.r2.y), m22 = _mm256_set1_pd(matrix.r2.z);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m256d x, y, z;
+        load_vectors(&in[i].x, x, y, z);
+        const __m256d tx = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m00, x), _mm256_mul_pd(m01, y)), _mm256_mul_pd(m02, z));
+        const __m256d ty = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m10, x), _mm256_mul_pd(m11, y)), _mm256_mul_pd(m12, z));
+        const __m256d tz = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(m20, x), _mm256_mul_pd(m21, y)), _mm256_mul_pd(m22, z));
+        store_vectors(&out[i].x, tx, ty, tz);
+    }
+#elif defined(POINTY_SSE2)
+    const __m128d m00 = _mm_set1_pd(matrix.r0.x), m01 = _mm_set1_pd(matrix.r0.y), m02 = _mm_set1_pd(matrix.r0.z);
+    const __m128d m10 = _mm_set1_pd(matrix.r1.x), m11 = _mm_set1_pd(matrix.r1.y), m12 = _mm_set1_pd(matrix.r1.z);
+    const __m128d m20 = _mm_set1_pd(matrix.r2.x), m21 = _mm_set1_pd(matrix.r2.y), m22 = _mm_set1_pd(matrix.r2.z);
+    for (; i + 2 <= count; i += 2)
+    {
+        __m128d x, y, z;
+        load_vectors(&in[i].x, x, y, z);
+        const __m128d tx = _mm_add_pd(_mm_add_pd(_mm_mul_pd(m00, x), _mm_mul_pd(m01, y)), _mm_mul_pd(m02, z));
+        const __m128d ty = _mm_add_pd(_mm_add_pd(_mm_mul_pd(m10, x), _mm_mul_pd(m11, y)), _mm_mul_pd(m12, z));
+        const __m128d tz = _mm_add_pd(_mm_add_pd(_mm_mul_pd(m20, x), _mm_mul_pd(m21, y)), _mm_mul_pd(m22, z));
+        store_vectors(&out[i].x, tx, ty, tz);
+    }
+#endif
+
+    for (; i < count; ++i)
+        out[i] = matrix * in[i];
+}
+
+/**
+ * \brief Returns the name of the instruction set the kernels were compiled for
+ */
+const char* batch_instruction_set()
+{
+#if defined(POINTY_AVX)
+    return "AVX";
+#elif defined(POINTY_SSE2)
+    return "SSE2";
+#else
+    return "scalar";
+#endif
+}
@@ -0,0 +1,30 @@
+#pragma once
+#include <cstddef>
+#include "linear_algebra.h"
+
+/**
+ * \brief Batch operations on arrays of vectors
+ *
+ * Each kernel has float and double versions that are vectorized with AVX or SSE when the compiler
+ * targets them (e.g. -mavx or /arch:AVX), and fall back to plain loops otherwise. The arrays may be
+ * of any length and alignment, in and out may be the same array.
+ */
+
+// Adds an offset to every vector, e.g. subtracting a gyroscope bias from a burst of packets
+void batch_add(Vec3f* vectors, const std::size_t& count, const Vec3f& offset);
+void batch_add(Vec3d* vectors, const std::size_t& count, const Vec3d& offset);
+
+// Multiplies every vector by a scalar, e.g. converting units
+void batch_scale(Vec3f* vectors, const std::size_t& count, const float& scalar);
+void batch_scale(Vec3d* vectors, const std::size_t& count, const double& scalar);
+
+// Writes the length of every vector
+void batch_length(const Vec3f* vectors, const std::size_t& count, float* lengths);
+void batch_length(const Vec3d* vectors, const std::size_t& count, double* lengths);
+
+// Multiplies every vector by a matrix, e.g. rotating a burst of packets into the earth frame
+void batch_transform(const Mat3f& matrix, const Vec3f* in, Vec3f* out, const std::size_t& count);
+void batch_transform(const Mat3d& matrix, const Vec3d* in, Vec3d* out, const std::size_t& count);
+
+// Name of the instruction set the kernels were compiled for
+const char* batch_instruction_set();